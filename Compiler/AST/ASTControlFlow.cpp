@@ -10,6 +10,7 @@
 #include "AST/ASTNode.hpp"
 #include "ASTControlFlow.hpp"
 #include "ASTMethod.hpp"
+#include "ASTUnary.hpp"
 #include "ASTVariables.hpp"
 #include "Analysis/FunctionAnalyser.hpp"
 #include "Compiler.hpp"
@@ -18,6 +19,7 @@
 #include "MemoryFlowAnalysis/MFFunctionAnalyser.hpp"
 #include "Scoping/SemanticScoper.hpp"
 #include "Types/TypeExpectation.hpp"
+#include "Types/ValueType.hpp"
 
 namespace EmojicodeCompiler {
 
@@ -113,12 +115,42 @@ void ASTErrorHandler::analyseMemoryFlow(MFFunctionAnalyser *analyser) {
     analyser->popScope(&errorBlock_);
 }
 
+/// Determines whether a 🔂 over a value of @c type can be compiled to an ASTCountedLoop.
+static bool countedLoopKind(const Type &type, Compiler *compiler, ASTCountedLoop::Kind *kind) {
+    if (type.type() != TypeType::Class && type.type() != TypeType::ValueType) {
+        return false;
+    }
+    auto definition = type.typeDefinition();
+    if (definition == compiler->sList) *kind = ASTCountedLoop::Kind::List;
+    else if (definition == compiler->sString) *kind = ASTCountedLoop::Kind::String;
+    else if (definition == compiler->sData) *kind = ASTCountedLoop::Kind::Data;
+    else if (definition == compiler->sRange) *kind = ASTCountedLoop::Kind::Range;
+    else return false;
+    return true;
+}
+
 void ASTForIn::analyse(FunctionAnalyser *analyser) {
     analyser->scoper().pushScope();
 
+    auto type = analyser->expect(TypeExpectation(false, false), &iteratee_);
+    auto &iterateeVar = analyser->scoper().currentScope().declareVariable(U"🔂iteratee", type, true, position());
+    iterateeVar.initialize();
+    iterateeVar_ = iterateeVar.id();
+
     ASTBlock newBlock(position());
 
-    auto getIterator = std::make_shared<ASTMethod>(std::u32string(1, E_DANGO), std::move(iteratee_),
+    ASTCountedLoop::Kind kind;
+    if (countedLoopKind(type, analyser->compiler(), &kind)) {
+        newBlock.appendNode(std::make_unique<ASTCountedLoop>(kind, iterateeVar_, type, varName_, std::move(block_),
+                                                             position()));
+        block_ = std::move(newBlock);
+        block_.analyse(analyser);
+        block_.popScope(analyser);
+        return;
+    }
+
+    auto getIterator = std::make_shared<ASTMethod>(std::u32string(1, E_DANGO),
+                                                   std::make_shared<ASTGetVariable>(U"🔂iteratee", position()),
                                                    ASTArguments(position()), position());
     newBlock.appendNode(std::make_unique<ASTConstantVariable>(U"iterator", getIterator, position()));
     auto getNext = std::make_shared<ASTMethod>(std::u32string(1, 0x1F53D),
@@ -136,6 +168,76 @@ void ASTForIn::analyse(FunctionAnalyser *analyser) {
 }
 
 void ASTForIn::analyseMemoryFlow(MFFunctionAnalyser *analyser) {
+    analyser->take(iteratee_.get());
+    analyser->recordVariableSet(iterateeVar_, iteratee_.get(), iteratee_->expressionType());
+    block_.analyseMemoryFlow(analyser);
+    analyser->popScope(&block_);
+}
+
+void ASTCountedLoop::analyse(FunctionAnalyser *analyser) {
+    auto compiler = analyser->compiler();
+    switch (kind_) {
+        case Kind::List:
+            elementType_ = compiler->sList->typeForVariable(0).resolveOn(TypeContext(iterateeType_));
+            break;
+        case Kind::Range:
+            elementType_ = Type(compiler->sInteger);
+            break;
+        case Kind::String:
+            elementType_ = Type(compiler->sSymbol).optionalized();
+            break;
+        case Kind::Data:
+            elementType_ = Type(compiler->sByte);
+            break;
+    }
+
+    if (iterateeType_.type() == TypeType::Class && !iterateeType_.isExact()) {
+        analyseFallback(analyser);
+    }
+
+    analyser->pathAnalyser().beginBranch();
+    analyser->scoper().pushScope();
+    auto &var = analyser->scoper().currentScope().declareVariable(varName_, elementType_, true, position());
+    var.initialize();
+    elementVar_ = var.id();
+    block_.analyse(analyser);
+    block_.popScope(analyser);
+    analyser->pathAnalyser().endBranch();
+    analyser->pathAnalyser().endUncertainBranches();
+}
+
+void ASTCountedLoop::analyseFallback(FunctionAnalyser *analyser) {
+    getIterator_ = std::make_shared<ASTMethod>(std::u32string(1, E_DANGO),
+                                               std::make_shared<ASTGetVariable>(U"🔂iteratee", position()),
+                                               ASTArguments(position()), position());
+    auto type = getIterator_->analyse(analyser, TypeExpectation(false, false));
+    // The iterator is only created if the fallback is taken and is therefore stored as an optional.
+    iteratorType_ = type.optionalized();
+    analyser->comply(type, TypeExpectation(iteratorType_), &getIterator_);
+
+    auto &var = analyser->scoper().currentScope().declareVariable(U"🔂iterator", iteratorType_, true, position());
+    var.initialize();
+    iteratorVar_ = var.id();
+
+    auto iterator = [this]() {
+        return std::make_shared<ASTUnwrap>(std::make_shared<ASTGetVariable>(U"🔂iterator", position()), position());
+    };
+    hasNext_ = std::make_shared<ASTMethod>(std::u32string(1, 0x1F53D), iterator(), ASTArguments(position(), false),
+                                           position());
+    analyser->expectType(analyser->boolean(), &hasNext_);
+    next_ = std::make_shared<ASTMethod>(std::u32string(1, 0x1F53D), iterator(), ASTArguments(position()), position());
+    analyser->expectType(elementType_, &next_);
+}
+
+void ASTCountedLoop::analyseMemoryFlow(MFFunctionAnalyser *analyser) {
+    if (hasFallback()) {
+        analyser->take(getIterator_.get());
+        analyser->recordVariableSet(iteratorVar_, getIterator_.get(), iteratorType_);
+        hasNext_->analyseMemoryFlow(analyser, MFFlowCategory::Borrowing);
+        analyser->take(next_.get());
+        next_->analyseMemoryFlow(analyser, MFFlowCategory::Escaping);
+    }
+    analyser->recordVariableSet(elementVar_, nullptr, elementType_);
     block_.analyseMemoryFlow(analyser);
     analyser->popScope(&block_);
 }
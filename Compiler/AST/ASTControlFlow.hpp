@@ -65,6 +65,57 @@ private:
     std::shared_ptr<ASTExpr> iteratee_;
     ASTBlock block_;
     std::u32string varName_;
+    VariableID iterateeVar_;
+};
+
+/// A loop over the elements of a 🍨, ⏩, 🔡 or 📇 that reads the elements directly by index instead of retrieving them
+/// through the 🍡 iterator protocol. ASTForIn creates this node if the static type of the iteratee is one of these
+/// types. If the type is a class and not exact, the iteratee could be an instance of a subclass that overrides 🐽 or
+/// 🍡. The loop then compares the class of the iteratee at run time and falls back to 🍡, 🔽❓ and 🔽 unless the
+/// iteratee is an instance of exactly that class.
+class ASTCountedLoop final : public ASTStatement {
+public:
+    enum class Kind {
+        List, Range, String, Data
+    };
+
+    ASTCountedLoop(Kind kind, VariableID iterateeVar, Type iterateeType, std::u32string varName, ASTBlock block,
+                   const SourcePosition &p)
+    : ASTStatement(p), kind_(kind), iterateeVar_(iterateeVar), iterateeType_(std::move(iterateeType)),
+    block_(std::move(block)), varName_(std::move(varName)) {}
+
+    void analyse(FunctionAnalyser *) override;
+    void generate(FunctionCodeGenerator *) const override;
+
+    void toCode(PrettyStream &pretty) const override {}
+    void analyseMemoryFlow(MFFunctionAnalyser *analyser) override;
+
+private:
+    Kind kind_;
+    VariableID iterateeVar_;
+    Type iterateeType_;
+    ASTBlock block_;
+    std::u32string varName_;
+    VariableID elementVar_;
+    Type elementType_ = Type::noReturn();
+
+    /// The calls used if the iteratee is an instance of a subclass. nullptr if the iteratee cannot be one.
+    std::shared_ptr<ASTExpr> getIterator_, hasNext_, next_;
+    VariableID iteratorVar_;
+    Type iteratorType_ = Type::noReturn();
+
+    bool hasFallback() const { return getIterator_ != nullptr; }
+    void analyseFallback(FunctionAnalyser *analyser);
+    /// Generates the condition and the element of the fallback loop. Branches to @c repeatBlock with the element or to
+    /// @c afterBlock.
+    llvm::Value* generateFallbackNext(FunctionCodeGenerator *fg, llvm::BasicBlock *repeatBlock,
+                                      llvm::BasicBlock *afterBlock) const;
+
+    /// Returns the value of the instance variable @c name of the iteratee.
+    llvm::Value* getField(FunctionCodeGenerator *fg, llvm::Value *iteratee, const std::u32string &name) const;
+    /// Returns the element at @c index from the memory in the instance variable @c name of the iteratee.
+    llvm::Value* getElement(FunctionCodeGenerator *fg, llvm::Value *iteratee, const std::u32string &name,
+                            llvm::Value *index) const;
 };
 
 class ASTErrorHandler final : public ASTStatement {
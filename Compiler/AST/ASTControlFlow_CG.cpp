@@ -10,6 +10,8 @@
 #include "Compiler.hpp"
 #include "Generation/CallCodeGenerator.hpp"
 #include "Generation/FunctionCodeGenerator.hpp"
+#include "Types/Class.hpp"
+#include "Types/TypeDefinition.hpp"
 
 namespace EmojicodeCompiler {
 
@@ -111,7 +113,143 @@ void ASTErrorHandler::generate(FunctionCodeGenerator *fg) const {
 }
 
 void ASTForIn::generate(FunctionCodeGenerator *fg) const {
+    fg->scoper().getVariable(iterateeVar_) = LocalVariable(false, iteratee_->generate(fg));
+    fg->releaseTemporaryObjects();
+    block_.generate(fg);
+}
+
+llvm::Value* ASTCountedLoop::getField(FunctionCodeGenerator *fg, llvm::Value *iteratee,
+                                      const std::u32string &name) const {
+    auto id = iterateeType_.typeDefinition()->instanceScope().getLocalVariable(name).id();
+    if (iterateeType_.type() == TypeType::ValueType) {
+        return fg->builder().CreateExtractValue(iteratee, id);
+    }
+    auto type = llvm::cast<llvm::PointerType>(iteratee->getType())->getElementType();
+    return fg->builder().CreateLoad(fg->builder().CreateConstInBoundsGEP2_32(type, iteratee, 0, id));
+}
+
+llvm::Value* ASTCountedLoop::getElement(FunctionCodeGenerator *fg, llvm::Value *iteratee, const std::u32string &name,
+                                        llvm::Value *index) const {
+    auto llvmType = fg->typeHelper().llvmTypeFor(kind_ == Kind::String ? elementType_.optionalType() : elementType_);
+    auto offset = fg->builder().CreateAdd(fg->builder().CreateMul(index, fg->sizeOf(llvmType)),
+                                          fg->sizeOf(llvm::Type::getInt8PtrTy(fg->generator()->context())));
+    auto ptr = fg->builder().CreateBitCast(fg->builder().CreateGEP(getField(fg, iteratee, name), offset),
+                                           llvmType->getPointerTo());
+    auto val = fg->builder().CreateLoad(ptr);
+    if (elementType_.isManaged()) {
+        fg->retain(fg->isManagedByReference(elementType_) ? ptr : val, elementType_);
+    }
+    return val;
+}
+
+llvm::Value* ASTCountedLoop::generateFallbackNext(FunctionCodeGenerator *fg, llvm::BasicBlock *repeatBlock,
+                                                  llvm::BasicBlock *afterBlock) const {
+    auto *function = fg->builder().GetInsertBlock()->getParent();
+    auto nextBlock = llvm::BasicBlock::Create(fg->generator()->context(), "iteratorNext", function);
+
+    auto hasNext = hasNext_->generate(fg);
+    fg->releaseTemporaryObjects();
+    fg->builder().CreateCondBr(hasNext, nextBlock, afterBlock);
+
+    fg->builder().SetInsertPoint(nextBlock);
+    auto element = next_->generate(fg);
+    fg->releaseTemporaryObjects();
+    fg->builder().CreateBr(repeatBlock);
+    return element;
+}
+
+void ASTCountedLoop::generate(FunctionCodeGenerator *fg) const {
+    auto *function = fg->builder().GetInsertBlock()->getParent();
+    auto iteratee = fg->scoper().getVariable(iterateeVar_).value;
+
+    auto afterBlock = llvm::BasicBlock::Create(fg->generator()->context(), "afterCountedLoop");
+    auto condBlock = llvm::BasicBlock::Create(fg->generator()->context(), "countedLoopCond", function);
+    auto elementBlock = llvm::BasicBlock::Create(fg->generator()->context(), "countedLoopElement", function);
+    auto repeatBlock = llvm::BasicBlock::Create(fg->generator()->context(), "countedLoop", function);
+
+    llvm::Value *rangeCount = nullptr;
+    if (kind_ == Kind::Range) {
+        auto distance = fg->builder().CreateSub(getField(fg, iteratee, U"stop"), getField(fg, iteratee, U"start"));
+        rangeCount = fg->builder().CreateSDiv(distance, getField(fg, iteratee, U"step"));
+    }
+
+    auto indexPtr = fg->createEntryAlloca(llvm::Type::getInt64Ty(fg->generator()->context()), "index");
+    fg->builder().CreateStore(fg->int64(0), indexPtr);
+
+    llvm::Value *isExact = nullptr;
+    llvm::BasicBlock *fallbackCondBlock = nullptr;
+    if (hasFallback()) {
+        auto classInfo = fg->buildGetClassInfoFromObject(iteratee);
+        isExact = fg->builder().CreateICmpEQ(classInfo, iterateeType_.klass()->classInfo());
+
+        auto iteratorPtr = fg->createEntryAlloca(fg->typeHelper().llvmTypeFor(iteratorType_), "iterator");
+        fg->scoper().getVariable(iteratorVar_) = LocalVariable(true, iteratorPtr);
+        auto noIterator = iteratorType_.storageType() == StorageType::Box ?
+                fg->buildBoxOptionalWithoutValue() : fg->buildSimpleOptionalWithoutValue(iteratorType_);
+        fg->builder().CreateStore(noIterator, iteratorPtr);
+        fg->createIf(fg->builder().CreateNot(isExact), [&] {
+            fg->builder().CreateStore(getIterator_->generate(fg), iteratorPtr);
+            fg->releaseTemporaryObjects();
+        });
+        fallbackCondBlock = llvm::BasicBlock::Create(fg->generator()->context(), "iteratorCond", function);
+    }
+    fg->builder().CreateBr(condBlock);
+
+    fg->builder().SetInsertPoint(condBlock);
+    if (hasFallback()) {
+        auto countedCondBlock = llvm::BasicBlock::Create(fg->generator()->context(), "countedLoopIndex", function);
+        fg->builder().CreateCondBr(isExact, countedCondBlock, fallbackCondBlock);
+        fg->builder().SetInsertPoint(countedCondBlock);
+    }
+    auto index = fg->builder().CreateLoad(indexPtr);
+    // The count of lists, strings and data is reloaded in every iteration as the body may change it.
+    auto count = rangeCount != nullptr ? rangeCount : getField(fg, iteratee, U"count");
+    fg->builder().CreateCondBr(fg->builder().CreateICmpSLT(index, count), elementBlock, afterBlock);
+
+    fg->builder().SetInsertPoint(elementBlock);
+    fg->builder().CreateStore(fg->builder().CreateAdd(index, fg->int64(1)), indexPtr);
+
+    llvm::Value *element = nullptr;
+    switch (kind_) {
+        case Kind::List:
+        case Kind::Data:
+            element = getElement(fg, iteratee, U"data", index);
+            break;
+        case Kind::String:
+            element = fg->buildSimpleOptionalWithValue(getElement(fg, iteratee, U"codePoints", index), elementType_);
+            break;
+        case Kind::Range:
+            element = fg->builder().CreateAdd(getField(fg, iteratee, U"start"),
+                                              fg->builder().CreateMul(index, getField(fg, iteratee, U"step")));
+            break;
+    }
+    auto countedElementBlock = fg->builder().GetInsertBlock();
+    fg->builder().CreateBr(repeatBlock);
+
+    if (hasFallback()) {
+        fg->builder().SetInsertPoint(fallbackCondBlock);
+        auto fallbackElement = generateFallbackNext(fg, repeatBlock, afterBlock);
+        auto fallbackElementBlock = fg->builder().GetInsertBlock();
+
+        fg->builder().SetInsertPoint(repeatBlock);
+        auto phi = fg->builder().CreatePHI(element->getType(), 2);
+        phi->addIncoming(element, countedElementBlock);
+        phi->addIncoming(fallbackElement, fallbackElementBlock);
+        element = phi;
+    }
+    else {
+        fg->builder().SetInsertPoint(repeatBlock);
+    }
+
+    fg->scoper().getVariable(elementVar_) = LocalVariable(false, element);
     block_.generate(fg);
+
+    if (!block_.returnedCertainly()) {
+        fg->builder().CreateBr(condBlock);
+    }
+
+    function->getBasicBlockList().push_back(afterBlock);
+    fg->builder().SetInsertPoint(afterBlock);
 }
 
 }  // namespace EmojicodeCompiler
@@ -97,7 +97,8 @@ void ASTSuper::analyseSuperInit(FunctionAnalyser *analyser) {
 }
 
 void ASTSuper::analyseMemoryFlow(MFFunctionAnalyser *analyser, MFFlowCategory type) {
-    analyser->recordThis(function_->memoryFlowTypeForThis());
+    auto detached = function_->isAsync() && !args_.isAwaited();
+    analyser->recordThis(detached ? MFFlowCategory::Escaping : function_->memoryFlowTypeForThis());
     analyser->analyseFunctionCall(&args_, nullptr, function_);
 }
 
@@ -141,12 +141,16 @@ public:
     void toCode(PrettyStream &pretty) const;
     bool isImperative() const { return imperative_; }
     void setImperative(bool imperative) { imperative_ = imperative; }
+    /// Whether the call is the operand of ⏸ and the caller is suspended until the called ⏯ function has returned.
+    bool isAwaited() const { return awaited_; }
+    void setAwaited() { awaited_ = true; }
 
     const std::vector<Type>& genericArgumentTypes() const { return genericArgumentsTypes_; }
     void setGenericArgumentTypes(std::vector<Type> types) { genericArgumentsTypes_ = std::move(types); }
 
 private:
     bool imperative_ = true;
+    bool awaited_ = false;
     std::vector<std::shared_ptr<ASTType>> genericArguments_;
     std::vector<std::shared_ptr<ASTExpr>> arguments_;
     std::vector<Type> genericArgumentsTypes_;
@@ -177,6 +181,8 @@ public:
     void toCode(PrettyStream &pretty) const override;
     void analyseMemoryFlow(MFFunctionAnalyser *, MFFlowCategory) override;
 
+    ASTArguments& args() { return args_; }
+
 private:
     void analyseSuperInit(FunctionAnalyser *analyser);
     std::u32string name_;
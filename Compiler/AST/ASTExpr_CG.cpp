@@ -63,7 +63,7 @@ Value* ASTSuper::generate(FunctionCodeGenerator *fg) const {
         fg->createIfElseBranchCond(fg->buildGetIsError(ret), [&]() {
             auto enumValue = fg->builder().CreateExtractValue(ret, 0);
             buildDestruct(fg);
-            fg->builder().CreateRet(fg->buildSimpleErrorWithError(enumValue, fg->llvmReturnType()));
+            fg->createReturn(fg->buildSimpleErrorWithError(enumValue, fg->llvmReturnType()));
             return false;
         }, [] { return true; });
     }
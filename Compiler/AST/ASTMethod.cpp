@@ -150,6 +150,14 @@ bool ASTMethodable::builtIn(FunctionAnalyser *analyser, const Type &type, const
             builtIn_ = BuiltInType::IntegerNot;
             return true;
         }
+        if (name.front() == 0x1F4A1) {
+            builtIn_ = BuiltInType::IntegerPopCount;
+            return true;
+        }
+        if (name.front() == 0x1F463) {
+            builtIn_ = BuiltInType::IntegerTrailingZeros;
+            return true;
+        }
     }
     else if (type.typeDefinition() == analyser->compiler()->sByte) {
         if (name.front() == E_NO_ENTRY_SIGN) {
@@ -170,6 +178,14 @@ bool ASTMethodable::builtIn(FunctionAnalyser *analyser, const Type &type, const
             builtIn_ = BuiltInType::Release;
             return true;
         }
+        if (name.front() == 0x1F4CC) {
+            builtIn_ = BuiltInType::RetainRange;
+            return true;
+        }
+        if (name.front() == 0x1F5D1) {
+            builtIn_ = BuiltInType::ReleaseRange;
+            return true;
+        }
         if (name.front() == 0x1F69C) {
             builtIn_ = BuiltInType::MemoryMove;
             return true;
@@ -178,6 +194,26 @@ bool ASTMethodable::builtIn(FunctionAnalyser *analyser, const Type &type, const
             builtIn_ = BuiltInType::MemorySet;
             return true;
         }
+        if (name.front() == 0x1F52D) {
+            builtIn_ = BuiltInType::AtomicLoad;
+            return true;
+        }
+        if (name.front() == 0x1F4E1) {
+            builtIn_ = BuiltInType::AtomicStore;
+            return true;
+        }
+        if (name.front() == 0x1F503) {
+            builtIn_ = BuiltInType::AtomicExchange;
+            return true;
+        }
+        if (name.front() == 0x1F3AD) {
+            builtIn_ = BuiltInType::AtomicCompareExchange;
+            return true;
+        }
+        if (name.front() == 0x1F4B9) {
+            builtIn_ = BuiltInType::AtomicAdd;
+            return true;
+        }
     }
     return false;
 }
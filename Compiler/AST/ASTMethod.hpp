@@ -11,6 +11,8 @@
 
 #include "ASTExpr.hpp"
 #include "Functions/CallType.h"
+#include <llvm/Support/AtomicOrdering.h>
+#include <functional>
 #include <utility>
 
 namespace EmojicodeCompiler {
@@ -35,9 +37,11 @@ protected:
         DoubleLess, DoubleLessOrEqual, DoubleRemainder, DoubleEqual,
         IntegerMultiply, IntegerAdd, IntegerSubstract, IntegerDivide, IntegerGreater, IntegerGreaterOrEqual,
         IntegerLess, IntegerLessOrEqual, IntegerLeftShift, IntegerRightShift, IntegerOr, IntegerAnd, IntegerXor,
-        IntegerRemainder, IntegerToDouble, IntegerNot,
+        IntegerRemainder, IntegerToDouble, IntegerNot, IntegerPopCount, IntegerTrailingZeros,
         BooleanAnd, BooleanOr, BooleanNegate,
-        Equal, Store, Load, Release, MemoryMove, MemorySet, IsNoValueLeft, IsNoValueRight, Multiprotocol,
+        Equal, Store, Load, Release, RetainRange, ReleaseRange, MemoryMove, MemorySet, IsNoValueLeft, IsNoValueRight,
+        Multiprotocol,
+        AtomicLoad, AtomicStore, AtomicExchange, AtomicCompareExchange, AtomicAdd,
     };
 
     BuiltInType builtIn_ = BuiltInType::None;
@@ -68,6 +72,8 @@ public:
     Value* generate(FunctionCodeGenerator *fg) const override;
     void analyseMemoryFlow(MFFunctionAnalyser *analyser, MFFlowCategory type) override;
 
+    ASTArguments& args() { return args_; }
+
 private:
     std::u32string name_;
     std::shared_ptr<ASTExpr> callee_;
@@ -75,6 +81,15 @@ private:
     llvm::Value* buildMemoryAddress(FunctionCodeGenerator *fg, llvm::Value *memory, llvm::Value *offset,
                                     const Type &type) const;
     llvm::Value* buildAddOffsetAddress(FunctionCodeGenerator *fg, llvm::Value *memory, llvm::Value *offset) const;
+    /// Retains or releases *count* consecutive values of type *type* starting at *first* in a single loop.
+    void buildManageRange(FunctionCodeGenerator *fg, llvm::Value *first, llvm::Value *count, const Type &type,
+                          bool retain) const;
+    /// Returns the address of the 🔢 located *offset* bytes past the beginning of *memory*.
+    llvm::Value* buildAtomicAddress(FunctionCodeGenerator *fg, llvm::Value *memory, llvm::Value *offset) const;
+    /// Calls *build* with the ordering represented by the ⛓ value *order* and returns its result. If *order* is not a
+    /// constant, a switch over all orderings is built and *build* is called once for every case.
+    llvm::Value* buildAtomic(FunctionCodeGenerator *fg, llvm::Value *order,
+                             const std::function<llvm::Value* (llvm::AtomicOrdering)> &build) const;
 };
 
 }  // namespace EmojicodeCompiler
@@ -9,15 +9,56 @@
 #include "ASTMethod.hpp"
 #include "Generation/CallCodeGenerator.hpp"
 #include "Generation/FunctionCodeGenerator.hpp"
+#include <llvm/IR/Intrinsics.h>
 
 namespace EmojicodeCompiler {
 
+/// The orderings in the order of the values of ⛓.
+static const llvm::AtomicOrdering kAtomicOrderings[] = {
+    llvm::AtomicOrdering::Monotonic, llvm::AtomicOrdering::Acquire, llvm::AtomicOrdering::Release,
+    llvm::AtomicOrdering::AcquireRelease, llvm::AtomicOrdering::SequentiallyConsistent,
+};
+
+/// Loads cannot release, so the release part of *ordering* is dropped.
+static llvm::AtomicOrdering loadOrdering(llvm::AtomicOrdering ordering) {
+    switch (ordering) {
+        case llvm::AtomicOrdering::Release:
+            return llvm::AtomicOrdering::Monotonic;
+        case llvm::AtomicOrdering::AcquireRelease:
+            return llvm::AtomicOrdering::Acquire;
+        default:
+            return ordering;
+    }
+}
+
+/// Stores cannot acquire, so the acquire part of *ordering* is dropped.
+static llvm::AtomicOrdering storeOrdering(llvm::AtomicOrdering ordering) {
+    switch (ordering) {
+        case llvm::AtomicOrdering::Acquire:
+            return llvm::AtomicOrdering::Monotonic;
+        case llvm::AtomicOrdering::AcquireRelease:
+            return llvm::AtomicOrdering::Release;
+        default:
+            return ordering;
+    }
+}
+
 Value* ASTMethod::generate(FunctionCodeGenerator *fg) const {
     if (builtIn_ != BuiltInType::None) {
         auto v = callee_->generate(fg);
         switch (builtIn_) {
             case BuiltInType::IntegerNot:
                 return fg->builder().CreateNot(v);
+            case BuiltInType::IntegerPopCount: {
+                auto ctpop = llvm::Intrinsic::getDeclaration(fg->generator()->module(), llvm::Intrinsic::ctpop,
+                                                             v->getType());
+                return fg->builder().CreateCall(ctpop, v);
+            }
+            case BuiltInType::IntegerTrailingZeros: {
+                auto cttz = llvm::Intrinsic::getDeclaration(fg->generator()->module(), llvm::Intrinsic::cttz,
+                                                            v->getType());
+                return fg->builder().CreateCall(cttz, { v, llvm::ConstantInt::getFalse(fg->generator()->context()) });
+            }
             case BuiltInType::IntegerToDouble:
                 return fg->builder().CreateSIToFP(v, llvm::Type::getDoubleTy(fg->generator()->context()));
             case BuiltInType::BooleanNegate:
@@ -49,6 +90,16 @@ Value* ASTMethod::generate(FunctionCodeGenerator *fg) const {
                 }
                 return nullptr;
             }
+            case BuiltInType::RetainRange:
+            case BuiltInType::ReleaseRange: {
+                auto type = args_.genericArguments().front()->type();
+                if (type.isManaged()) {
+                    auto first = buildMemoryAddress(fg, v, args_.args()[0]->generate(fg), type);
+                    buildManageRange(fg, first, args_.args()[1]->generate(fg), type,
+                                     builtIn_ == BuiltInType::RetainRange);
+                }
+                return nullptr;
+            }
             case BuiltInType::MemoryMove: {
                 fg->builder().CreateMemMove(buildAddOffsetAddress(fg, v, args_.args()[0]->generate(fg)),
                                             buildAddOffsetAddress(fg, args_.args()[1]->generate(fg),
@@ -61,6 +112,49 @@ Value* ASTMethod::generate(FunctionCodeGenerator *fg) const {
                                            args_.args()[0]->generate(fg), args_.args()[2]->generate(fg), 0);
                 return nullptr;
             }
+            case BuiltInType::AtomicLoad: {
+                auto ptr = buildAtomicAddress(fg, v, args_.args()[0]->generate(fg));
+                auto order = args_.args()[1]->generate(fg);
+                return buildAtomic(fg, order, [fg, ptr](llvm::AtomicOrdering ordering) -> llvm::Value* {
+                    auto load = fg->builder().CreateLoad(ptr);
+                    load->setAtomic(loadOrdering(ordering));
+                    load->setAlignment(8);
+                    return load;
+                });
+            }
+            case BuiltInType::AtomicStore: {
+                auto val = args_.args()[0]->generate(fg);
+                auto ptr = buildAtomicAddress(fg, v, args_.args()[1]->generate(fg));
+                auto order = args_.args()[2]->generate(fg);
+                return buildAtomic(fg, order, [fg, ptr, val](llvm::AtomicOrdering ordering) -> llvm::Value* {
+                    auto store = fg->builder().CreateStore(val, ptr);
+                    store->setAtomic(storeOrdering(ordering));
+                    store->setAlignment(8);
+                    return nullptr;
+                });
+            }
+            case BuiltInType::AtomicExchange:
+            case BuiltInType::AtomicAdd: {
+                auto op = builtIn_ == BuiltInType::AtomicAdd ? llvm::AtomicRMWInst::Add : llvm::AtomicRMWInst::Xchg;
+                auto val = args_.args()[0]->generate(fg);
+                auto ptr = buildAtomicAddress(fg, v, args_.args()[1]->generate(fg));
+                auto order = args_.args()[2]->generate(fg);
+                return buildAtomic(fg, order, [fg, op, ptr, val](llvm::AtomicOrdering ordering) -> llvm::Value* {
+                    return fg->builder().CreateAtomicRMW(op, ptr, val, ordering);
+                });
+            }
+            case BuiltInType::AtomicCompareExchange: {
+                auto expected = args_.args()[0]->generate(fg);
+                auto desired = args_.args()[1]->generate(fg);
+                auto ptr = buildAtomicAddress(fg, v, args_.args()[2]->generate(fg));
+                auto order = args_.args()[3]->generate(fg);
+                auto compareExchange = [fg, ptr, expected, desired](llvm::AtomicOrdering ordering) -> llvm::Value* {
+                    auto pair = fg->builder().CreateAtomicCmpXchg(ptr, expected, desired, ordering,
+                                                                  loadOrdering(ordering));
+                    return fg->builder().CreateExtractValue(pair, 1);
+                };
+                return buildAtomic(fg, order, compareExchange);
+            }
             case BuiltInType::Multiprotocol:
                 return MultiprotocolCallCodeGenerator(fg, callType_).generate(callee_->generate(fg), calleeType_, args_,
                                                                               method_, multiprotocolN_);
@@ -84,4 +178,74 @@ Value* ASTMethod::buildMemoryAddress(FunctionCodeGenerator *fg, llvm::Value *mem
     return fg->builder().CreateBitCast(buildAddOffsetAddress(fg, memory, offset), ptrType);
 }
 
+void ASTMethod::buildManageRange(FunctionCodeGenerator *fg, llvm::Value *first, llvm::Value *count,
+                                 const Type &type, bool retain) const {
+    auto function = fg->builder().GetInsertBlock()->getParent();
+    auto entry = fg->builder().GetInsertBlock();
+    auto loop = llvm::BasicBlock::Create(fg->generator()->context(), "manageRange", function);
+    auto cont = llvm::BasicBlock::Create(fg->generator()->context(), "manageRangeCont", function);
+
+    auto zero = llvm::ConstantInt::get(count->getType(), 0);
+    fg->builder().CreateCondBr(fg->builder().CreateICmpSGT(count, zero), loop, cont);
+
+    fg->builder().SetInsertPoint(loop);
+    auto index = fg->builder().CreatePHI(count->getType(), 2);
+    index->addIncoming(zero, entry);
+    auto ptr = fg->builder().CreateGEP(first, index);
+    if (retain) {
+        fg->retain(fg->isManagedByReference(type) ? ptr : fg->builder().CreateLoad(ptr), type);
+    }
+    else {
+        fg->releaseByReference(ptr, type);
+    }
+    auto next = fg->builder().CreateAdd(index, llvm::ConstantInt::get(count->getType(), 1));
+    index->addIncoming(next, fg->builder().GetInsertBlock());
+    fg->builder().CreateCondBr(fg->builder().CreateICmpSLT(next, count), loop, cont);
+
+    fg->builder().SetInsertPoint(cont);
+}
+
+llvm::Value* ASTMethod::buildAtomicAddress(FunctionCodeGenerator *fg, llvm::Value *memory,
+                                           llvm::Value *offset) const {
+    return fg->builder().CreateBitCast(buildAddOffsetAddress(fg, memory, offset),
+                                       llvm::Type::getInt64PtrTy(fg->generator()->context()));
+}
+
+llvm::Value* ASTMethod::buildAtomic(FunctionCodeGenerator *fg, llvm::Value *order,
+                                    const std::function<llvm::Value* (llvm::AtomicOrdering)> &build) const {
+    if (auto constant = llvm::dyn_cast<llvm::ConstantInt>(order)) {
+        auto index = constant->getZExtValue();
+        return build(index < 5 ? kAtomicOrderings[index] : llvm::AtomicOrdering::SequentiallyConsistent);
+    }
+
+    auto function = fg->builder().GetInsertBlock()->getParent();
+    auto cont = llvm::BasicBlock::Create(fg->generator()->context(), "atomicCont", function);
+    std::vector<std::pair<llvm::Value *, llvm::BasicBlock *>> results;
+
+    // Any value that is not a valid ⛓ is treated as the strongest ordering.
+    auto sequentiallyConsistent = llvm::BasicBlock::Create(fg->generator()->context(), "atomic", function);
+    auto switchInst = fg->builder().CreateSwitch(order, sequentiallyConsistent, 4);
+    for (size_t i = 0; i < 5; i++) {
+        auto block = sequentiallyConsistent;
+        if (i < 4) {
+            block = llvm::BasicBlock::Create(fg->generator()->context(), "atomic", function);
+            switchInst->addCase(llvm::ConstantInt::get(llvm::cast<llvm::IntegerType>(order->getType()), i), block);
+        }
+        fg->builder().SetInsertPoint(block);
+        auto result = build(kAtomicOrderings[i]);
+        results.emplace_back(result, fg->builder().GetInsertBlock());
+        fg->builder().CreateBr(cont);
+    }
+
+    fg->builder().SetInsertPoint(cont);
+    if (results.front().first == nullptr) {
+        return nullptr;
+    }
+    auto phi = fg->builder().CreatePHI(results.front().first->getType(), results.size());
+    for (auto &result : results) {
+        phi->addIncoming(result.first, result.second);
+    }
+    return phi;
+}
+
 }  // namespace EmojicodeCompiler
@@ -27,10 +27,10 @@ void ASTReturn::generate(FunctionCodeGenerator *fg) const {
     if (value_) {
         auto val = value_->generate(fg);
         fg->releaseTemporaryObjects();
-        fg->builder().CreateRet(val);
+        fg->createReturn(val);
     }
     else {
-        fg->builder().CreateRetVoid();
+        fg->createReturn(nullptr);
     }
 }
 
@@ -42,13 +42,13 @@ void ASTRaise::generate(FunctionCodeGenerator *fg) const {
         fg->builder().CreateStore(value_->generate(fg), ptr);
         auto val = fg->builder().CreateLoad(box);
         fg->releaseTemporaryObjects();
-        fg->builder().CreateRet(val);
+        fg->createReturn(val);
     }
     else {
         auto val = fg->buildSimpleErrorWithError(value_->generate(fg), fg->llvmReturnType());
         fg->releaseTemporaryObjects();
         buildDestruct(fg);
-        fg->builder().CreateRet(val);
+        fg->createReturn(val);
     }
 }
 
@@ -7,8 +7,10 @@
 //
 
 #include "ASTUnary.hpp"
+#include "ASTMethod.hpp"
 #include "Analysis/FunctionAnalyser.hpp"
 #include "CompilerError.hpp"
+#include "Functions/Function.hpp"
 #include "Types/TypeExpectation.hpp"
 #include "MemoryFlowAnalysis/MFFunctionAnalyser.hpp"
 
@@ -40,4 +42,20 @@ Type ASTUnwrap::analyse(FunctionAnalyser *analyser, const TypeExpectation &expec
     throw CompilerError(position(), "🍺 can only be used with optionals or 🚨.");
 }
 
+Type ASTAwait::analyse(FunctionAnalyser *analyser, const TypeExpectation &expectation) {
+    if (!analyser->function()->isAsync()) {
+        throw CompilerError(position(), "⏸ can only be used in ⏯ functions.");
+    }
+    if (auto method = std::dynamic_pointer_cast<ASTMethod>(expr_)) {
+        method->args().setAwaited();
+    }
+    else if (auto super = std::dynamic_pointer_cast<ASTSuper>(expr_)) {
+        super->args().setAwaited();
+    }
+    else {
+        throw CompilerError(position(), "⏸ can only be used with a method call.");
+    }
+    return analyser->expect(TypeExpectation(false, false), &expr_);
+}
+
 }  // namespace EmojicodeCompiler
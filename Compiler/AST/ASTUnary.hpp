@@ -38,6 +38,17 @@ private:
     Value* generateErrorUnwrap(FunctionCodeGenerator *fg) const;
 };
 
+/// Awaits the call to an ⏯ function that is ::expr_. Only marks the call as awaited, the suspension of the caller is
+/// generated along with the call by CallCodeGenerator.
+class ASTAwait final : public ASTUnaryMFForwarding {
+    using ASTUnaryMFForwarding::ASTUnaryMFForwarding;
+public:
+    Type analyse(FunctionAnalyser *analyser, const TypeExpectation &expectation) override;
+    Value* generate(FunctionCodeGenerator *fg) const override;
+
+    void toCode(PrettyStream &pretty) const override;
+};
+
 }  // namespace EmojicodeCompiler
 
 #endif /* ASTUnary_hpp */
@@ -65,5 +65,9 @@ Value* ASTUnwrap::generateErrorUnwrap(FunctionCodeGenerator *fg) const {
     }
     return fg->builder().CreateExtractValue(error, 1);
 }
+
+Value* ASTAwait::generate(FunctionCodeGenerator *fg) const {
+    return expr_->generate(fg);
+}
     
 }  // namespace EmojicodeCompiler
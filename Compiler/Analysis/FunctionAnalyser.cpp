@@ -88,6 +88,28 @@ void FunctionAnalyser::checkFunctionUse(Function *function, const SourcePosition
     checkFunctionSafety(function, p);
 }
 
+void FunctionAnalyser::checkAsyncCall(const ASTArguments *node, Function *function) const {
+    if (!function->isAsync()) {
+        if (node->isAwaited()) {
+            compiler()->error(CompilerError(node->position(), utf8(function->name()), " is not ⏯ and cannot be ",
+                                            "awaited."));
+        }
+        return;
+    }
+    if (node->isAwaited()) {
+        return;
+    }
+    // A call that is not awaited starts the function, which continues on its own once it has been suspended. Nobody
+    // could take its return value then and a native function would have no coroutine to resume.
+    if (function->isAsyncNative()) {
+        compiler()->error(CompilerError(node->position(), utf8(function->name()), " must be awaited with ⏸."));
+    }
+    else if (function->returnType()->type().type() != TypeType::NoReturn) {
+        compiler()->error(CompilerError(node->position(), utf8(function->name()), " returns a value and must be ",
+                                        "awaited with ⏸."));
+    }
+}
+
 void FunctionAnalyser::checkFunctionSafety(Function *function, const SourcePosition &p) const {
     if (function->unsafe() && !inUnsafeBlock_) {
         compiler()->error(CompilerError(p, "Use of unsafe function ", utf8(function->name()), " requires ☣️  block."));
@@ -236,6 +258,7 @@ Type FunctionAnalyser::analyseFunctionCall(ASTArguments *node, const Type &type,
     }
     function->requestReification(genericArgs);
     checkFunctionUse(function, node->position());
+    checkAsyncCall(node, function);
     node->setGenericArgumentTypes(genericArgs);
     return function->returnType()->type().resolveOn(typeContext);
 }
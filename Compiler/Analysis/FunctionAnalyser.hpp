@@ -92,6 +92,8 @@ private:
     /// Checks that the function can be accessed or issues an error. Checks that the function is not deprecated
     /// and issues a warning otherwise.
     void checkFunctionUse(Function *function, const SourcePosition &p) const;
+    /// Checks that a call to an ⏯ function is awaited if it must be and that only calls to ⏯ functions are awaited.
+    void checkAsyncCall(const ASTArguments *node, Function *function) const;
 
     /// Returns true if exprType and expectation are callables and there is a mismatch between the argument or return
     /// StorageTypes.
@@ -195,6 +195,11 @@ std::unique_ptr<Function> SemanticAnalyser::enforcePromises(Function *sub, Funct
         package_->compiler()->error(CompilerError(sub->position(), "Overriding method must be as accessible or more ",
                                                   "accessible than the overridden method."));
     }
+    if (sub->isAsync() != super->isAsync()) {
+        package_->compiler()->error(CompilerError(sub->position(), utf8(sub->name()), " must be ⏯ if and only if ",
+                                                  "its implementation in ", superSource.toString(subContext),
+                                                  " is ⏯."));
+    }
 
     bool isReturnOk = checkReturnPromise(sub, subContext, super, superContext, superSource);
     bool isParamsOk = checkArgumentPromise(sub, super, subContext, superContext) ;
@@ -29,6 +29,9 @@ void buildBoxingThunkAst(Function *thunk, const Function *destinationFunction, c
     for (auto &param : thunk->parameters()) {
         args.addArguments(std::make_shared<ASTGetVariable>(param.name, p));
     }
+    if (thunk->isAsync()) {
+        args.setAwaited();
+    }
 
     std::shared_ptr<ASTExpr> call;
     if (destinationFunction == nullptr) {
@@ -74,6 +77,7 @@ std::unique_ptr<Function> buildBoxingThunk(const TypeContext &declarator, const
                                     methodImplementation->position(), std::move(params),
                                     method->returnType()->type().resolveOn(declarator),
                                     methodImplementation->functionType());
+    function->setAsync(methodImplementation->isAsync());
     buildBoxingThunkAst(function.get(), methodImplementation, Type::noReturn());
     return function;
 }
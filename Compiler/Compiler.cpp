@@ -191,10 +191,12 @@ void Compiler::assignSTypes(Package *s) {
     sSymbol = getStandardValueType(U"🔣", s);
     sMemory = getStandardValueType(U"🧠", s);
     sByte = getStandardValueType(U"💧", s);
+    sRange = getStandardValueType(U"⏩", s);
 
     sString = getStandardClass(U"🔡", s);
     sList = getStandardClass(U"🍨", s);
     sDictionary = getStandardClass(U"🍯", s);
+    sData = getStandardClass(U"📇", s);
 
     sEnumerable = getStandardProtocol(
             std::u32string(1, E_CLOCKWISE_RIGHTWARDS_AND_LEFTWARDS_OPEN_CIRCLE_ARROWS_WITH_CIRCLED_ONE_OVERLAY), s);
@@ -104,6 +104,7 @@ public:
     Class *sString = nullptr;
     Class *sList = nullptr;
     Class *sDictionary = nullptr;
+    Class *sData = nullptr;
     Protocol *sEnumerable = nullptr;
     ValueType *sBoolean = nullptr;
     ValueType *sSymbol = nullptr;
@@ -111,6 +112,7 @@ public:
     ValueType *sReal = nullptr;
     ValueType *sMemory = nullptr;
     ValueType *sByte = nullptr;
+    ValueType *sRange = nullptr;
 
     ~Compiler();
 
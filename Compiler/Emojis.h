@@ -105,6 +105,8 @@ enum Emojis {
     E_BAGGAGE_CLAIM = 0x1F6C4,
     E_LINK_SYMBOL = 0x1F517,
     E_RECYCLING_SYMBOL = 0x267B,
+    E_PLAY_OR_PAUSE_BUTTON = 0x23EF,
+    E_PAUSE_BUTTON = 0x23F8,
 };
 
 }  // namespace EmojicodeCompiler
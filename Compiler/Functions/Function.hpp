@@ -19,6 +19,7 @@
 namespace llvm {
 class Function;
 class FunctionType;
+class StructType;
 }  // namespace llvm
 
 namespace EmojicodeCompiler {
@@ -45,6 +46,9 @@ struct Parameter {
 class FunctionReification {
 public:
     llvm::Function *function = nullptr;
+    /// The type of the promise of an ⏯ function, which holds its state (0) and its return value (1).
+    /// @see FunctionCodeGenerator::buildAwait()
+    llvm::StructType *promiseType = nullptr;
     unsigned int vti() { return vti_; }
     void setVti(unsigned int vti) { vti_ = vti; }
     llvm::FunctionType* functionType();
@@ -117,6 +121,14 @@ public:
 
     void setMutating(bool v) { mutating_ = v; }
 
+    /// Whether the function is an ⏯ function, which can suspend in ⏸ and is therefore compiled to a coroutine.
+    bool isAsync() const { return async_; }
+    void setAsync(bool async) { async_ = async; }
+    /// Whether the function is an ⏯ function that is implemented natively instead of as coroutine. Such a function
+    /// is passed the handle of the coroutine that awaits it as last argument and must resume the coroutine once it is
+    /// done.
+    bool isAsyncNative() const { return async_ && !externalName_.empty(); }
+
     /** Returns the access level to this method. */
     AccessLevel accessLevel() const { return access_; }
 
@@ -171,6 +183,7 @@ private:
     bool unsafe_;
 
     bool mutating_;
+    bool async_ = false;
     bool external_ = false;
     bool closure_ = false;
 
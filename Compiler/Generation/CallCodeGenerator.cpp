@@ -22,6 +22,28 @@ llvm::Value *CallCodeGenerator::generate(llvm::Value *callee, const Type &type,
     auto args = createArgsVector(callee, astArgs);
 
     assert(function != nullptr);
+    if (!function->isAsync()) {
+        return dispatch(type, astArgs, function, std::move(args));
+    }
+    if (function->isAsyncNative()) {
+        auto save = fg()->buildCoroutineSave();
+        args.emplace_back(fg()->coroutineHandle());
+        dispatch(type, astArgs, function, std::move(args));
+        fg()->buildSuspend(save);
+        return nullptr;
+    }
+
+    auto handle = dispatch(type, astArgs, function, std::move(args));
+    auto promiseType = function->reificationFor(astArgs.genericArgumentTypes()).promiseType;
+    if (astArgs.isAwaited()) {
+        return fg()->buildAwait(handle, promiseType);
+    }
+    fg()->buildDetach(handle, promiseType);
+    return nullptr;
+}
+
+llvm::Value *CallCodeGenerator::dispatch(const Type &type, const ASTArguments &astArgs, Function *function,
+                                         std::vector<llvm::Value *> args) {
     switch (callType_) {
         case CallType::StaticContextfreeDispatch:
         case CallType::StaticDispatch: {
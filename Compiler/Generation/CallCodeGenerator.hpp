@@ -34,6 +34,10 @@ class ASTArguments;
 class CallCodeGenerator {
 public:
     CallCodeGenerator(FunctionCodeGenerator *fg, CallType callType) : fg_(fg), callType_(callType) {}
+    /// Generates the call. If @c function is ⏯, the call is awaited if the arguments are awaited and otherwise
+    /// detached. A call to a native ⏯ function passes the handle of the coroutine that is being generated, which
+    /// is suspended until the native function resumes it.
+    /// @returns The value returned by the function.
     llvm::Value* generate(llvm::Value *callee, const Type &type, const ASTArguments &astArgs,
                           Function *function);
 
@@ -45,6 +49,9 @@ protected:
                                                llvm::Value *conformance);
     llvm::Value* buildFindProtocolConformance(const std::vector<llvm::Value *> &args, const Type &protocol);
 private:
+    /// Calls the function as determined by the call type.
+    llvm::Value *dispatch(const Type &type, const ASTArguments &astArgs, Function *function,
+                          std::vector<llvm::Value *> args);
     llvm::Value *createDynamicDispatch(Function *function, const std::vector<llvm::Value *> &args,
                                        const std::vector<Type> &genericArgs);
     llvm::Value *dispatchFromVirtualTable(Function *function, llvm::Value *virtualTable,
@@ -54,6 +54,11 @@ void EmojicodeCompiler::Declarator::declareRunTime() {
     releaseCapture_ = declareRunTimeFunction("ejcReleaseCapture", llvm::Type::getVoidTy(generator_->context()),
                                             llvm::Type::getInt8PtrTy(generator_->context()));
 
+    coroutineAlloc_ = declareRunTimeFunction("ejcCoroutineAlloc", llvm::Type::getInt8PtrTy(generator_->context()),
+                                             llvm::Type::getInt64Ty(generator_->context()));
+    coroutineFree_ = declareRunTimeFunction("ejcCoroutineFree", llvm::Type::getVoidTy(generator_->context()),
+                                            llvm::Type::getInt8PtrTy(generator_->context()));
+
     ignoreBlock_ = new llvm::GlobalVariable(*generator_->module(), llvm::Type::getInt8Ty(generator_->context()), true,
                                             llvm::GlobalValue::LinkageTypes::ExternalLinkage, nullptr,
                                             "ejcIgnoreBlock");
@@ -117,6 +122,9 @@ void Declarator::declareLlvmFunction(Function *function) const {
         auto context = ReificationContext(*function, reification);
         generator_->typeHelper().setReificationContext(&context);
         auto ft = generator_->typeHelper().functionTypeFor(function);
+        if (function->isAsync()) {
+            reification.entity.promiseType = generator_->typeHelper().promiseTypeFor(function);
+        }
         generator_->typeHelper().setReificationContext(nullptr);
         auto name = function->externalName().empty() ? mangleFunction(function, reification.arguments)
                                                      : function->externalName();
@@ -126,6 +134,10 @@ void Declarator::declareLlvmFunction(Function *function) const {
         reification.entity.function = llvm::Function::Create(ft, linkage, name, generator_->module());
         reification.entity.function->addFnAttr(llvm::Attribute::NoUnwind);
 
+        if (function->isAsync()) {
+            return;  // The coroutine frame captures all arguments.
+        }
+
         size_t i = 0;
         if (hasThisArgument(function)) {
             if (!function->memoryFlowTypeForThis().isEscaping()) {
@@ -43,6 +43,10 @@ public:
     llvm::Function* releaseCapture() const { return releaseCapture_; }
     /// Used to find a protocol conformance in an array of ProtocolConformanceEntries. (ejcFindProtocolConformance)
     llvm::Function* findProtocolConformance() const { return findProtocolConformance_; }
+    /// The function that allocates the frame of a coroutine that cannot live on the stack. (ejcCoroutineAlloc)
+    llvm::Function* coroutineAlloc() const { return coroutineAlloc_; }
+    /// The function that frees a frame allocated with coroutineAlloc(). (ejcCoroutineFree)
+    llvm::Function* coroutineFree() const { return coroutineFree_; }
 
     llvm::GlobalVariable* ignoreBlockPtr() const { return ignoreBlock_; }
 
@@ -75,6 +79,8 @@ private:
     llvm::Function *release_ = nullptr;
     llvm::Function *releaseMemory_ = nullptr;
     llvm::Function *releaseCapture_ = nullptr;
+    llvm::Function *coroutineAlloc_ = nullptr;
+    llvm::Function *coroutineFree_ = nullptr;
 
     llvm::Function* declareRunTimeFunction(const char *name, llvm::Type *returnType, llvm::ArrayRef<llvm::Type *> args);
     void declareRunTime();
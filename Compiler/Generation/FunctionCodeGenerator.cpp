@@ -31,8 +31,16 @@ void FunctionCodeGenerator::generate() {
 
     declareArguments(function_);
 
+    if (fn_->isAsync()) {
+        createCoroutine();
+    }
+
     fn_->ast()->generate(this);
 
+    if (fn_->isAsync()) {
+        createCoroutineEnd();
+    }
+
     if (llvm::verifyFunction(*function_, &llvm::outs())) {}
 }
 
@@ -41,6 +49,180 @@ void FunctionCodeGenerator::createEntry() {
     builder_.SetInsertPoint(basicBlock);
 }
 
+llvm::Type* FunctionCodeGenerator::llvmReturnType() const {
+    if (promiseType_ != nullptr) {
+        return promiseType_->getNumElements() > 1 ? promiseType_->getElementType(1)
+                                                  : llvm::Type::getVoidTy(generator()->context());
+    }
+    return function_->getReturnType();
+}
+
+void FunctionCodeGenerator::createReturn(llvm::Value *value) {
+    if (promiseType_ == nullptr) {
+        if (value != nullptr) {
+            builder().CreateRet(value);
+        }
+        else {
+            builder().CreateRetVoid();
+        }
+        return;
+    }
+    if (value != nullptr) {
+        builder().CreateStore(value, builder().CreateConstInBoundsGEP2_32(promiseType_, promise_, 0, 1));
+    }
+    builder().CreateBr(finalBlock_);
+}
+
+void FunctionCodeGenerator::createCoroutine() {
+    auto &context = generator()->context();
+    auto i8PtrTy = llvm::Type::getInt8PtrTy(context);
+    promiseType_ = typeHelper().promiseTypeFor(fn_);
+    promise_ = createEntryAlloca(promiseType_, "promise");
+
+    auto null = llvm::ConstantPointerNull::get(i8PtrTy);
+    coroutineId_ = builder().CreateCall(intrinsic(llvm::Intrinsic::coro_id), {
+        int32(0), builder().CreateBitCast(promise_, i8PtrTy), null, null
+    });
+
+    auto entry = builder().GetInsertBlock();
+    auto allocBlock = llvm::BasicBlock::Create(context, "coro.alloc", function_);
+    auto beginBlock = llvm::BasicBlock::Create(context, "coro.begin", function_);
+    builder().CreateCondBr(builder().CreateCall(intrinsic(llvm::Intrinsic::coro_alloc), coroutineId_), allocBlock,
+                           beginBlock);
+
+    builder().SetInsertPoint(allocBlock);
+    auto size = builder().CreateCall(intrinsic(llvm::Intrinsic::coro_size, llvm::Type::getInt64Ty(context)));
+    auto frame = builder().CreateCall(generator()->declarator().coroutineAlloc(), size);
+    builder().CreateBr(beginBlock);
+
+    builder().SetInsertPoint(beginBlock);
+    auto memory = builder().CreatePHI(i8PtrTy, 2);
+    memory->addIncoming(null, entry);
+    memory->addIncoming(frame, allocBlock);
+    coroutineHandle_ = builder().CreateCall(intrinsic(llvm::Intrinsic::coro_begin), { coroutineId_, memory });
+    builder().CreateStore(int64(0), builder().CreateConstInBoundsGEP2_32(promiseType_, promise_, 0, 0));
+
+    finalBlock_ = llvm::BasicBlock::Create(context, "coro.final", function_);
+    cleanupBlock_ = llvm::BasicBlock::Create(context, "coro.cleanup", function_);
+    suspendBlock_ = llvm::BasicBlock::Create(context, "coro.suspend", function_);
+
+    auto it = function_->args().begin();
+    if (hasThisArgument(fn_)) {
+        retainCoroutineArgument(&*(it++), fn_->typeContext().calleeType());
+    }
+    for (auto &arg : fn_->parameters()) {
+        retainCoroutineArgument(&*(it++), arg.type->type());
+    }
+}
+
+void FunctionCodeGenerator::retainCoroutineArgument(llvm::Value *value, const Type &type) {
+    if (!type.isManaged()) {
+        return;
+    }
+    auto ptr = createEntryAlloca(value->getType());
+    builder().CreateStore(value, ptr);
+    retain(isManagedByReference(type) ? ptr : value, type);
+    coroutineArguments_.emplace_back(ptr, type);
+}
+
+void FunctionCodeGenerator::createCoroutineEnd() {
+    builder().SetInsertPoint(finalBlock_);
+    for (auto &argument : coroutineArguments_) {
+        releaseByReference(argument.value, argument.type);
+    }
+    auto save = buildCoroutineSave();
+    auto statePtr = builder().CreateConstInBoundsGEP2_32(promiseType_, promise_, 0, 0);
+    auto state = builder().CreateAtomicRMW(llvm::AtomicRMWInst::Xchg, statePtr, int64(1),
+                                           llvm::AtomicOrdering::AcquireRelease);
+    auto awaitedBlock = llvm::BasicBlock::Create(generator()->context(), "coro.awaited", function_);
+    builder().CreateCondBr(builder().CreateICmpEQ(state, int64(2)), cleanupBlock_, awaitedBlock);
+    builder().SetInsertPoint(awaitedBlock);
+    createIf(builder().CreateICmpUGT(state, int64(2)), [&] {
+        auto awaiter = builder().CreateIntToPtr(state, llvm::Type::getInt8PtrTy(generator()->context()));
+        builder().CreateCall(intrinsic(llvm::Intrinsic::coro_resume), awaiter);
+    });
+    auto suspend = builder().CreateCall(intrinsic(llvm::Intrinsic::coro_suspend), { save, builder().getTrue() });
+    auto unreachable = llvm::BasicBlock::Create(generator()->context(), "coro.unreachable", function_);
+    createSuspendSwitch(suspend, unreachable);
+    builder().SetInsertPoint(unreachable);
+    builder().CreateUnreachable();
+
+    builder().SetInsertPoint(cleanupBlock_);
+    auto memory = builder().CreateCall(intrinsic(llvm::Intrinsic::coro_free), { coroutineId_, coroutineHandle_ });
+    auto null = llvm::ConstantPointerNull::get(llvm::Type::getInt8PtrTy(generator()->context()));
+    createIf(builder().CreateICmpNE(memory, null), [&] {
+        builder().CreateCall(generator()->declarator().coroutineFree(), memory);
+    });
+    builder().CreateBr(suspendBlock_);
+
+    builder().SetInsertPoint(suspendBlock_);
+    builder().CreateCall(intrinsic(llvm::Intrinsic::coro_end), { coroutineHandle_, builder().getFalse() });
+    builder().CreateRet(coroutineHandle_);
+}
+
+llvm::Value* FunctionCodeGenerator::buildCoroutineSave() {
+    return builder().CreateCall(intrinsic(llvm::Intrinsic::coro_save), coroutineHandle_);
+}
+
+void FunctionCodeGenerator::buildSuspend(llvm::Value *save) {
+    auto suspend = builder().CreateCall(intrinsic(llvm::Intrinsic::coro_suspend), { save, builder().getFalse() });
+    auto resume = llvm::BasicBlock::Create(generator()->context(), "coro.resume", function_);
+    createSuspendSwitch(suspend, resume);
+    builder().SetInsertPoint(resume);
+}
+
+void FunctionCodeGenerator::createSuspendSwitch(llvm::Value *suspend, llvm::BasicBlock *resume) {
+    auto sw = builder().CreateSwitch(suspend, suspendBlock_, 2);
+    sw->addCase(llvm::ConstantInt::get(llvm::Type::getInt8Ty(generator()->context()), 0), resume);
+    sw->addCase(llvm::ConstantInt::get(llvm::Type::getInt8Ty(generator()->context()), 1), cleanupBlock_);
+}
+
+llvm::Value* FunctionCodeGenerator::buildPromisePtr(llvm::Value *handle, llvm::StructType *promiseType) {
+    auto alignment = generator()->module()->getDataLayout().getABITypeAlignment(promiseType);
+    auto promise = builder().CreateCall(intrinsic(llvm::Intrinsic::coro_promise), {
+        handle, int32(alignment), builder().getFalse()
+    });
+    return builder().CreateBitCast(promise, promiseType->getPointerTo());
+}
+
+llvm::Value* FunctionCodeGenerator::buildAwait(llvm::Value *handle, llvm::StructType *promiseType) {
+    auto promise = buildPromisePtr(handle, promiseType);
+    auto statePtr = builder().CreateConstInBoundsGEP2_32(promiseType, promise, 0, 0);
+    auto save = buildCoroutineSave();
+    auto self = builder().CreatePtrToInt(coroutineHandle_, llvm::Type::getInt64Ty(generator()->context()));
+    auto exchange = builder().CreateAtomicCmpXchg(statePtr, int64(0), self, llvm::AtomicOrdering::AcquireRelease,
+                                                  llvm::AtomicOrdering::Acquire);
+
+    auto suspendBlock = llvm::BasicBlock::Create(generator()->context(), "await.suspend", function_);
+    auto readyBlock = llvm::BasicBlock::Create(generator()->context(), "await.ready", function_);
+    builder().CreateCondBr(builder().CreateExtractValue(exchange, 1), suspendBlock, readyBlock);
+    builder().SetInsertPoint(suspendBlock);
+    auto suspend = builder().CreateCall(intrinsic(llvm::Intrinsic::coro_suspend), { save, builder().getFalse() });
+    createSuspendSwitch(suspend, readyBlock);
+
+    builder().SetInsertPoint(readyBlock);
+    llvm::Value *value = nullptr;
+    if (promiseType->getNumElements() > 1) {
+        value = builder().CreateLoad(builder().CreateConstInBoundsGEP2_32(promiseType, promise, 0, 1));
+    }
+    builder().CreateCall(intrinsic(llvm::Intrinsic::coro_destroy), handle);
+    return value;
+}
+
+void FunctionCodeGenerator::buildDetach(llvm::Value *handle, llvm::StructType *promiseType) {
+    auto promise = buildPromisePtr(handle, promiseType);
+    auto statePtr = builder().CreateConstInBoundsGEP2_32(promiseType, promise, 0, 0);
+    auto state = builder().CreateAtomicRMW(llvm::AtomicRMWInst::Xchg, statePtr, int64(2),
+                                           llvm::AtomicOrdering::AcquireRelease);
+    createIf(builder().CreateICmpEQ(state, int64(1)), [&] {
+        builder().CreateCall(intrinsic(llvm::Intrinsic::coro_destroy), handle);
+    });
+}
+
+llvm::Function* FunctionCodeGenerator::intrinsic(llvm::Intrinsic::ID id, llvm::ArrayRef<llvm::Type *> types) {
+    return llvm::Intrinsic::getDeclaration(generator()->module(), id, types);
+}
+
 Compiler* FunctionCodeGenerator::compiler() const {
     return generator()->package()->compiler();
 }
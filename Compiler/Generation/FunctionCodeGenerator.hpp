@@ -12,8 +12,10 @@
 #include "CodeGenerator.hpp"
 #include "Scoping/IDScoper.hpp"
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
 #include <functional>
 #include <queue>
+#include <vector>
 
 namespace EmojicodeCompiler {
 
@@ -50,7 +52,13 @@ public:
     llvm::IRBuilder<>& builder() { return builder_; }
     LLVMTypeHelper& typeHelper() { return generator()->typeHelper(); }
     virtual llvm::Value* thisValue() const { return &*function_->args().begin(); }
-    llvm::Type* llvmReturnType() const { return function_->getReturnType(); }
+    /// @returns The type of the values the function returns. For an ⏯ function this is the type of the result
+    /// stored in its promise and not the type of the coroutine handle the LLVM function returns.
+    llvm::Type* llvmReturnType() const;
+
+    /// Returns @c value, which must be @c nullptr if the function does not return a value, from the function.
+    /// In an ⏯ function the value is stored in the promise and the coroutine is completed.
+    void createReturn(llvm::Value *value);
 
     llvm::Value* instanceVariablePointer(size_t id);
 
@@ -172,6 +180,26 @@ public:
     /// @see addTemporaryObject
     void releaseTemporaryObjects();
 
+    /// @returns The handle of the coroutine of the ⏯ function that is being generated.
+    llvm::Value* coroutineHandle() const { return coroutineHandle_; }
+    /// Marks the point after which the coroutine can be resumed by another thread. Must be followed by
+    /// buildSuspend() and nothing in between must access the coroutine frame.
+    llvm::Value* buildCoroutineSave();
+    /// Suspends the coroutine at a point saved with buildCoroutineSave(). The builder is positioned at the block
+    /// that continues when the coroutine is resumed.
+    void buildSuspend(llvm::Value *save);
+    /// Suspends the coroutine until the coroutine @c handle of the ⏯ function, whose promise is of type
+    /// @c promiseType, completed, destroys it and returns its result.
+    ///
+    /// The state in the promise is 0 while the coroutine runs, 1 once it completed and 2 if it was detached.
+    /// Any other value is the handle of the coroutine awaiting it, which is resumed once it completes. As the handle
+    /// does not escape, LLVM can place the frame of the awaited coroutine in the frame of the awaiting one.
+    /// @returns The value returned by the awaited function or @c nullptr if it does not return a value.
+    llvm::Value* buildAwait(llvm::Value *handle, llvm::StructType *promiseType);
+    /// Gives up the coroutine @c handle. The coroutine destroys itself once it completes.
+    /// @see buildAwait()
+    void buildDetach(llvm::Value *handle, llvm::StructType *promiseType);
+
 protected:
     virtual void declareArguments(llvm::Function *function);
     Function* function() const { return fn_; }
@@ -192,6 +220,30 @@ private:
 
     std::queue<Temporary> temporaryObjects_;
 
+    llvm::StructType *promiseType_ = nullptr;
+    llvm::Value *promise_ = nullptr;
+    llvm::Value *coroutineId_ = nullptr;
+    llvm::Value *coroutineHandle_ = nullptr;
+    /// The block to which all returns of an ⏯ function branch.
+    llvm::BasicBlock *finalBlock_ = nullptr;
+    /// The block that frees the coroutine frame when the coroutine is destroyed.
+    llvm::BasicBlock *cleanupBlock_ = nullptr;
+    /// The block that returns to the caller or resumer whenever the coroutine suspends.
+    llvm::BasicBlock *suspendBlock_ = nullptr;
+    /// Arguments retained by an ⏯ function so that they are alive while it is suspended. They are provided as
+    /// pointers and released when the function completes.
+    std::vector<Temporary> coroutineArguments_;
+
+    /// Creates the coroutine of an ⏯ function and retains its arguments.
+    void createCoroutine();
+    /// Generates the final, cleanup and suspend block of an ⏯ function.
+    void createCoroutineEnd();
+    void retainCoroutineArgument(llvm::Value *value, const Type &type);
+    /// Branches on the result of llvm.coro.suspend to @c resume, the cleanup block or the suspend block.
+    void createSuspendSwitch(llvm::Value *suspend, llvm::BasicBlock *resume);
+    llvm::Value* buildPromisePtr(llvm::Value *handle, llvm::StructType *promiseType);
+    llvm::Function* intrinsic(llvm::Intrinsic::ID id, llvm::ArrayRef<llvm::Type *> types = llvm::None);
+
     /// @param retain True if the box should be released, false if it should be retained.
     void manageBox(bool retain, llvm::Value *boxInfo, llvm::Value *value, const Type &type);
 
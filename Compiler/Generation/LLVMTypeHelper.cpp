@@ -97,6 +97,13 @@ llvm::FunctionType* LLVMTypeHelper::functionTypeFor(Function *function) {
     std::transform(function->parameters().begin(), function->parameters().end(), std::back_inserter(args), [this](auto &arg) {
         return llvmTypeFor(arg.type->type());
     });
+    if (function->isAsyncNative()) {
+        args.emplace_back(llvm::Type::getInt8PtrTy(context_));
+        return llvm::FunctionType::get(llvm::Type::getVoidTy(context_), args, false);
+    }
+    if (function->isAsync()) {
+        return llvm::FunctionType::get(llvm::Type::getInt8PtrTy(context_), args, false);
+    }
     llvm::Type *returnType;
     if (function->functionType() == FunctionType::ObjectInitializer) {
         auto init = dynamic_cast<Initializer *>(function);
@@ -108,6 +115,14 @@ llvm::FunctionType* LLVMTypeHelper::functionTypeFor(Function *function) {
     return llvm::FunctionType::get(returnType, args, false);
 }
 
+llvm::StructType* LLVMTypeHelper::promiseTypeFor(Function *function) {
+    std::vector<llvm::Type *> types { llvm::Type::getInt64Ty(context_) };
+    if (function->returnType()->type().type() != TypeType::NoReturn) {
+        types.emplace_back(llvmTypeFor(function->returnType()->type()));
+    }
+    return llvm::StructType::get(context_, types);
+}
+
 llvm::Type* LLVMTypeHelper::box() const {
     return box_;
 }
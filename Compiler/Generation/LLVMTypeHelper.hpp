@@ -45,6 +45,9 @@ public:
     /// @returns An LLVM function type (a signature) matching the provided Function.
     /// @throws std::logic_error if no type can be established. This will normally not happen.
     llvm::FunctionType* functionTypeFor(Function *function);
+    /// @returns The type of the promise of the provided ⏯ function, which holds the state of the coroutine and, if
+    /// the function returns a value, the return value.
+    llvm::StructType* promiseTypeFor(Function *function);
 
     /// @returns True if it is guaranteed that the provided type is represnted as a pointer at run-time that can always
     /// be dereferenced.
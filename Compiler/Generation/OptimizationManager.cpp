@@ -3,6 +3,7 @@
 //
 
 #include "OptimizationManager.hpp"
+#include <llvm/Transforms/Coroutines.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Scalar.h>
@@ -15,31 +16,31 @@ OptimizationManager::OptimizationManager(llvm::Module *module, bool optimize)
             passManager_(std::make_unique<llvm::legacy::PassManager>()) {}
 
 void OptimizationManager::initialize() {
+    // The coroutine passes lower the coroutines of ⏯ functions and must therefore run even if not optimizing.
+    llvm::PassManagerBuilder builder;
+    builder.OptLevel = optimize_ ? 3 : 0;
+    builder.SizeLevel = 0;
     if (optimize_) {
-        llvm::PassManagerBuilder builder;
-        builder.OptLevel = 3;
-        builder.SizeLevel = 0;
         builder.Inliner = llvm::createFunctionInliningPass();
+    }
+    llvm::addCoroutinePassesToExtensionPoints(builder);
 
-        builder.populateFunctionPassManager(*functionPassManager_);
-        builder.populateModulePassManager(*passManager_);
+    builder.populateFunctionPassManager(*functionPassManager_);
+    builder.populateModulePassManager(*passManager_);
 
+    if (optimize_) {
         functionPassManager_->add(llvm::createInductiveRangeCheckEliminationPass());
         functionPassManager_->add(llvm::createLICMPass());
-        functionPassManager_->doInitialization();
     }
+    functionPassManager_->doInitialization();
 }
 
 void OptimizationManager::optimize(llvm::Function *function) {
-    if (optimize_) {
-        functionPassManager_->run(*function);
-    }
+    functionPassManager_->run(*function);
 }
 
 void OptimizationManager::optimize(llvm::Module *module) {
-    if (optimize_) {
-        passManager_->run(*module);
-    }
+    passManager_->run(*module);
 }
 
 }  // namespace EmojicodeCompiler
@@ -46,11 +46,16 @@ void MFFunctionAnalyser::analyseFunctionCall(ASTArguments *node, ASTExpr *callee
     if (function->memoryFlowTypeForThis().isUnknown()) {
         MFFunctionAnalyser(function).analyse();
     }
+    // An ⏯ function that is not awaited may still run after it was suspended and the statement that called it
+    // ended, wherefore all values passed to it escape. An awaited function, however, returns before the caller resumes
+    // and the values are used just as by any other function.
+    auto detached = function->isAsync() && !node->isAwaited();
     if (callee != nullptr) {
-        callee->analyseMemoryFlow(this, function->memoryFlowTypeForThis());
+        callee->analyseMemoryFlow(this, detached ? MFFlowCategory::Escaping : function->memoryFlowTypeForThis());
     }
     for (size_t i = 0; i < node->args().size(); i++) {
-        node->args()[i]->analyseMemoryFlow(this, function->parameters()[i].memoryFlowType);
+        node->args()[i]->analyseMemoryFlow(this, detached ? MFFlowCategory::Escaping :
+                                                            function->parameters()[i].memoryFlowType);
     }
 }
 
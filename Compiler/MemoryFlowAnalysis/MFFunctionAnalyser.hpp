@@ -80,7 +80,8 @@ public:
 
     /// Analyses a function call.
     /// Analyses the callee and arguments with the appropriate flow category. If the specified function was not
-    /// memory flow analysed, analyses the function first.
+    /// memory flow analysed, analyses the function first. The callee and arguments of an ⏯ function that is not
+    /// awaited always escape.
     void analyseFunctionCall(ASTArguments *node, ASTExpr *callee, Function *function);
 
     /// This method must be called after having analysed an ASTBlock.
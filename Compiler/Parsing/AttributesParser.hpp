@@ -25,7 +25,7 @@ class TokenStream;
 enum class Attribute : char32_t {
     Deprecated = E_WARNING_SIGN, Final = E_LOCK_WITH_INK_PEN, Override = E_BLACK_NIB, StaticOnType = E_RABBIT,
     Required = E_KEY, Export = E_EARTH_GLOBE_EUROPE_AFRICA, Foreign = E_RADIO, Unsafe = E_BIOHAZARD,
-    Mutating = E_CRAYON, Escaping = E_LEFT_LUGGAGE,
+    Mutating = E_CRAYON, Escaping = E_LEFT_LUGGAGE, Async = E_PLAY_OR_PAUSE_BUTTON,
 };
 
 template <Attribute ...Attributes>
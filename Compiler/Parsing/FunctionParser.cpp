@@ -275,6 +275,8 @@ std::shared_ptr<ASTExpr> FunctionParser::parseExprIdentifier(const Token &token)
             return parseUnaryPrefix<ASTIsError>(token);
         case E_BEER_MUG:
             return parseUnaryPrefix<ASTUnwrap>(token);
+        case E_PAUSE_BUTTON:
+            return parseUnaryPrefix<ASTAwait>(token);
         case E_SCALES:
             return std::make_shared<ASTSizeOf>(parseType(), token.position());
         case E_BLACK_SQUARE_BUTTON: {
@@ -90,6 +90,11 @@ template <typename TypeDef>
 void TypeBodyParser<TypeDef>::doParseMethod(const std::u32string &name, TypeBodyAttributeParser attributes,
                                  const Documentation &documentation, AccessLevel access, bool imperative,
                                  const SourcePosition &p) {
+    // The callee of an instance method of a value type or enum is passed by reference and would not outlive a
+    // suspension.
+    if (std::is_same<TypeDef, Class>::value || attributes.has(Attribute::StaticOnType)) {
+        attributes.allow(Attribute::Async);
+    }
     attributes.allow(Attribute::Deprecated).allow(Attribute::StaticOnType).allow(Attribute::Unsafe)
             .allow(Attribute::Escaping).check(p, package_->compiler());
 
@@ -100,6 +105,7 @@ void TypeBodyParser<TypeDef>::doParseMethod(const std::u32string &name, TypeBody
                                                      true, imperative, attributes.has(Attribute::Unsafe),
                                                      std::is_same<TypeDef, Class>::value ?
                                                      FunctionType::ClassMethod : FunctionType::Function);
+        typeMethod->setAsync(attributes.has(Attribute::Async));
         parseFunction(typeMethod.get(), false, attributes.has(Attribute::Escaping));
         typeDef_->addTypeMethod(std::move(typeMethod));
     }
@@ -111,6 +117,7 @@ void TypeBodyParser<TypeDef>::doParseMethod(const std::u32string &name, TypeBody
                                                  attributes.has(Attribute::Unsafe),
                                                  std::is_same<TypeDef, Class>::value ? FunctionType::ObjectMethod :
                                                  FunctionType::ValueTypeMethod);
+        method->setAsync(attributes.has(Attribute::Async));
         parseFunction(method.get(), false, attributes.has(Attribute::Escaping));
         typeDef_->addMethod(std::move(method));
     }
@@ -265,6 +272,9 @@ template<>
 void TypeBodyParser<Protocol>::parseMethod(const std::u32string &name, TypeBodyAttributeParser attributes,
                                            const Documentation &documentation, AccessLevel access, bool imperative,
                                            const SourcePosition &p) {
+    if (attributes.has(Attribute::Async)) {
+        throw CompilerError(p, "Protocol methods cannot be ⏯.");
+    }
     auto method = std::make_unique<Function>(name, AccessLevel::Public, false, typeDef_, package_,
                                              p, false, documentation.get(),
                                              attributes.has(Attribute::Deprecated), false, imperative, false,
@@ -19,7 +19,8 @@ class Initializer;
 class CompilerError;
 
 using TypeBodyAttributeParser = AttributeParser<Attribute::Deprecated, Attribute::Final, Attribute::Override,
-    Attribute::StaticOnType, Attribute::Unsafe, Attribute::Mutating, Attribute::Required, Attribute::Escaping>;
+    Attribute::StaticOnType, Attribute::Unsafe, Attribute::Mutating, Attribute::Required, Attribute::Escaping,
+    Attribute::Async>;
 
 /// TypeBodyParser parses $type-body$s of $type-definition$s, which are
 /// represented by TypeDefinition. Some methods of this class are specialized for some types.
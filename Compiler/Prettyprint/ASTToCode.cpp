@@ -209,6 +209,11 @@ void ASTUnwrap::toCode(PrettyStream &pretty) const {
     pretty << " 🍺" << expr_;
 }
 
+void ASTAwait::toCode(PrettyStream &pretty) const {
+    pretty.printComments(position());
+    pretty << "⏸" << expr_;
+}
+
 void ASTNumberLiteral::toCode(PrettyStream &pretty) const {
     pretty.printComments(position());
     pretty << string_;
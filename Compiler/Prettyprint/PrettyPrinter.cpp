@@ -296,6 +296,9 @@ void PrettyPrinter::printFunctionAttributes(Function *function, bool noMutate) {
     if (!function->memoryFlowTypeForThis().isUnknown() && function->memoryFlowTypeForThis().isEscaping()) {
         prettyStream_ << "🛅 ";
     }
+    if (function->isAsync()) {
+        prettyStream_ << "⏯ ";
+    }
 }
 
 void PrettyPrinter::printFunctionAccessLevel(Function *function) {
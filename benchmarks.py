@@ -0,0 +1,23 @@
+from subprocess import *
+import glob
+import os
+import dist
+import sys
+
+# Benchmarks print their timings and are not compared against an expected
+# output. Pass the names of benchmarks to only run these.
+selected = sys.argv[2:]
+
+emojicodec = os.path.abspath("Compiler/emojicodec")
+os.environ["EMOJICODE_PACKAGES_PATH"] = os.path.abspath(".")
+
+paths = sorted(glob.glob(os.path.join(dist.source, "tests", "benchmarks",
+                                      "*.emojic")))
+
+for source_path in paths:
+    name = os.path.splitext(os.path.basename(source_path))[0]
+    if len(selected) > 0 and name not in selected:
+        continue
+    print("⏱  {0}".format(name), flush=True)
+    run([emojicodec, source_path, '-O'], check=True)
+    run([os.path.splitext(source_path)[0]], check=True)
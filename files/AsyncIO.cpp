@@ -0,0 +1,533 @@
+//
+// Batched asynchronous reads and writes at offsets.
+//
+
+#include "../s/String.h"
+#include "../runtime/Runtime.h"
+#include "../s/Data.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+#define FILES_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#endif
+
+using s::String;
+using s::Data;
+
+namespace files {
+
+runtime::Enum errorEnumFromErrno();
+
+static runtime::Enum errorEnumFromResult(int64_t result) {
+    errno = static_cast<int>(-result);
+    return errorEnumFromErrno();
+}
+
+class Descriptor : public runtime::Object<Descriptor> {
+public:
+    int fd = -1;
+};
+
+class Queue;
+
+class Operation : public runtime::Object<Operation> {
+public:
+    Operation(Queue *queue, Descriptor *file, Data *data, bool write, runtime::Integer offset);
+    ~Operation();
+
+    /// Not retained, as pending operations are owned by the queue. Closing the queue submits them and waits for all
+    /// operations, so the queue outlives every operation that has not completed.
+    Queue *queue;
+    Descriptor *file;
+    /// The data to write or the buffer into which is read.
+    Data *data;
+    bool write;
+    runtime::Integer offset;
+    struct iovec vector;
+    /// The number of bytes transferred or the negated error number.
+    int64_t result = 0;
+    bool submitted = false;
+    std::atomic_bool done { false };
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    void complete(int64_t result) {
+        if (!write && result >= 0) {
+            data->count = result;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->result = result;
+            done = true;
+        }
+        finished.notify_all();
+    }
+
+    /// Performs the operation on the calling thread.
+    int64_t perform() {
+        ssize_t n;
+        do {
+            n = write ? pwrite(file->fd, vector.iov_base, vector.iov_len, offset)
+                      : pread(file->fd, vector.iov_base, vector.iov_len, offset);
+        } while (n == -1 && errno == EINTR);
+        return n == -1 ? -errno : n;
+    }
+};
+
+/// Carries out the operations of a Queue. A backend retains every operation it has been handed until it has
+/// completed. All methods must be called from the thread that uses the Queue.
+class Backend {
+public:
+    virtual ~Backend() = default;
+    /// Starts all operations in *operations*.
+    virtual void submit(const std::vector<Operation *> &operations) = 0;
+    /// Blocks until *operation*, which must have been submitted, has completed.
+    virtual void wait(Operation *operation) = 0;
+    /// Blocks until all submitted operations have completed.
+    virtual void waitAll() = 0;
+    virtual bool usesKernelQueue() const = 0;
+};
+
+/// Performs the operations of all ThreadPoolBackend instances with blocking pread() and pwrite() calls.
+class IOThreadPool {
+public:
+    static constexpr unsigned kThreads = 8;
+
+    static IOThreadPool& shared() {
+        static auto pool = new IOThreadPool();
+        return *pool;
+    }
+
+    void run(const std::vector<Operation *> &operations) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.insert(queue_.end(), operations.begin(), operations.end());
+        }
+        wakeUp_.notify_all();
+    }
+
+private:
+    IOThreadPool() {
+        for (unsigned i = 0; i < kThreads; i++) {
+            std::thread([this] { work(); }).detach();
+        }
+    }
+
+    void work();
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::deque<Operation *> queue_;
+};
+
+class ThreadPoolBackend : public Backend {
+public:
+    void submit(const std::vector<Operation *> &operations) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            outstanding_ += operations.size();
+        }
+        IOThreadPool::shared().run(operations);
+    }
+
+    void wait(Operation *operation) override {
+        std::unique_lock<std::mutex> lock(operation->mutex);
+        operation->finished.wait(lock, [operation] { return operation->done.load(); });
+    }
+
+    void waitAll() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        allDone_.wait(lock, [this] { return outstanding_ == 0; });
+    }
+
+    bool usesKernelQueue() const override { return false; }
+
+    /// Called by the pool after an operation has completed.
+    void finished() {
+        // Notify while holding the lock as the backend may be destructed as soon as waitAll() has returned.
+        std::lock_guard<std::mutex> lock(mutex_);
+        outstanding_--;
+        allDone_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable allDone_;
+    size_t outstanding_ = 0;
+};
+
+#ifdef FILES_IO_URING
+
+/// Submits operations to the kernel through an io_uring submission queue and takes their results from the completion
+/// queue. Submitting a batch costs one system call no matter how many operations it contains.
+class KernelQueueBackend : public Backend {
+public:
+    /// Returns nullptr if the kernel does not support io_uring or it is not permitted.
+    static KernelQueueBackend* create(unsigned entries) {
+        io_uring_params params{};
+        auto fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return nullptr;
+        }
+        auto backend = new KernelQueueBackend(fd);
+        if (!backend->map(params)) {
+            delete backend;
+            return nullptr;
+        }
+        return backend;
+    }
+
+    ~KernelQueueBackend() override {
+        if (sqes_ != nullptr) munmap(sqes_, sqesSize_);
+        if (cqRing_ != nullptr && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+        if (sqRing_ != nullptr) munmap(sqRing_, sqRingSize_);
+        close(fd_);
+    }
+
+    void submit(const std::vector<Operation *> &operations) override {
+        for (auto operation : operations) {
+            // Never have more operations in flight than fit into the completion queue, which would otherwise overflow.
+            while (inflight_ + unsubmitted_ == cqEntries_) {
+                enter(unsubmitted_, 1);
+                reap();
+            }
+            if (unsubmitted_ == sqEntries_) {
+                enter(unsubmitted_, 0);
+            }
+            auto tail = *sqTail_;
+            auto index = tail & *sqMask_;
+            auto &sqe = sqes_[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = operation->write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe.fd = operation->file->fd;
+            sqe.off = operation->offset;
+            sqe.addr = reinterpret_cast<uint64_t>(&operation->vector);
+            sqe.len = 1;
+            sqe.user_data = reinterpret_cast<uint64_t>(operation);
+            sqArray_[index] = index;
+            __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+            unsubmitted_++;
+        }
+        enter(unsubmitted_, 0);
+    }
+
+    void wait(Operation *operation) override {
+        reap();
+        while (!operation->done) {
+            enter(0, 1);
+            reap();
+        }
+    }
+
+    void waitAll() override {
+        reap();
+        while (inflight_ > 0) {
+            enter(0, 1);
+            reap();
+        }
+    }
+
+    bool usesKernelQueue() const override { return true; }
+
+private:
+    explicit KernelQueueBackend(int fd) : fd_(fd) {}
+
+    bool map(const io_uring_params &params) {
+        sqEntries_ = params.sq_entries;
+        cqEntries_ = params.cq_entries;
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        auto singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+
+        sqRing_ = mapRegion(sqRingSize_, IORING_OFF_SQ_RING);
+        if (sqRing_ == nullptr) return false;
+        cqRing_ = singleMap ? sqRing_ : mapRegion(cqRingSize_, IORING_OFF_CQ_RING);
+        if (cqRing_ == nullptr) return false;
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe *>(mapRegion(sqesSize_, IORING_OFF_SQES));
+        if (sqes_ == nullptr) return false;
+
+        auto sq = static_cast<char *>(sqRing_);
+        sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        auto cq = static_cast<char *>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void* mapRegion(size_t size, off_t offset) {
+        auto region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return region == MAP_FAILED ? nullptr : region;
+    }
+
+    /// Submits *toSubmit* operations and waits until at least *minComplete* operations have completed.
+    void enter(unsigned toSubmit, unsigned minComplete) {
+        while (true) {
+            auto flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+            auto n = syscall(__NR_io_uring_enter, fd_, toSubmit, minComplete, flags, nullptr, 0);
+            if (n >= 0) {
+                unsubmitted_ -= n;
+                inflight_ += n;
+                if (static_cast<unsigned>(n) == toSubmit) {
+                    return;
+                }
+                toSubmit -= n;
+                minComplete = 0;
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EAGAIN || errno == EBUSY) && inflight_ > 0) {
+                reap();
+                minComplete = 1;
+                continue;
+            }
+            if (errno == EAGAIN || errno == EBUSY) {
+                std::this_thread::yield();
+                continue;
+            }
+            ejcPanic("io_uring_enter failed.");
+        }
+    }
+
+    /// Completes all operations in the completion queue.
+    void reap() {
+        std::vector<Operation *> completed;
+        auto head = *cqHead_;
+        while (head != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+            auto &cqe = cqes_[head & *cqMask_];
+            auto operation = reinterpret_cast<Operation *>(cqe.user_data);
+            operation->complete(cqe.res);
+            completed.emplace_back(operation);
+            head++;
+            inflight_--;
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        for (auto operation : completed) {
+            operation->release();
+        }
+    }
+
+    int fd_;
+    unsigned sqEntries_ = 0;
+    unsigned cqEntries_ = 0;
+    unsigned unsubmitted_ = 0;
+    unsigned inflight_ = 0;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+    void *sqRing_ = nullptr;
+    void *cqRing_ = nullptr;
+    io_uring_sqe *sqes_ = nullptr;
+    unsigned *sqTail_ = nullptr;
+    unsigned *sqMask_ = nullptr;
+    unsigned *sqArray_ = nullptr;
+    unsigned *cqHead_ = nullptr;
+    unsigned *cqTail_ = nullptr;
+    unsigned *cqMask_ = nullptr;
+    io_uring_cqe *cqes_ = nullptr;
+};
+
+#endif
+
+class Queue : public runtime::Object<Queue> {
+public:
+    Backend *backend = nullptr;
+    /// Operations that have been queued but not submitted yet.
+    std::vector<Operation *> pending;
+
+    void submit() {
+        if (pending.empty()) {
+            return;
+        }
+        for (auto operation : pending) {
+            operation->submitted = true;
+        }
+        backend->submit(pending);
+        pending.clear();
+    }
+};
+
+Operation::Operation(Queue *queue, Descriptor *file, Data *data, bool write, runtime::Integer offset)
+        : queue(queue), file(file), data(data), write(write), offset(offset) {
+    file->retain();
+    vector.iov_base = data->data.get();
+    vector.iov_len = data->count;
+}
+
+Operation::~Operation() {
+    data->release();
+    file->release();
+}
+
+void IOThreadPool::work() {
+    while (true) {
+        Operation *operation;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeUp_.wait(lock, [this] { return !queue_.empty(); });
+            operation = queue_.front();
+            queue_.pop_front();
+        }
+        operation->complete(operation->perform());
+        static_cast<ThreadPoolBackend *>(operation->queue->backend)->finished();
+        operation->release();
+    }
+}
+
+static runtime::SimpleError<Descriptor*> openDescriptor(String *path, int flags) {
+    auto fd = open(path->stdString().c_str(), flags, 0644);
+    if (fd == -1) {
+        return { runtime::MakeError, errorEnumFromErrno() };
+    }
+    auto descriptor = Descriptor::init();
+    descriptor->fd = fd;
+    return descriptor;
+}
+
+extern "C" runtime::SimpleError<Descriptor*> filesDescriptorNewReading(String *path) {
+    return openDescriptor(path, O_RDONLY);
+}
+
+extern "C" runtime::SimpleError<Descriptor*> filesDescriptorNewWriting(String *path) {
+    return openDescriptor(path, O_WRONLY | O_CREAT | O_TRUNC);
+}
+
+extern "C" runtime::SimpleError<runtime::Integer> filesDescriptorSize(Descriptor *descriptor) {
+    struct stat st{};
+    if (fstat(descriptor->fd, &st) != 0) {
+        return { runtime::MakeError, errorEnumFromErrno() };
+    }
+    return st.st_size;
+}
+
+extern "C" void filesDescriptorClose(Descriptor *descriptor) {
+    if (descriptor->fd != -1) {
+        close(descriptor->fd);
+        descriptor->fd = -1;
+    }
+}
+
+extern "C" Queue* filesQueueNew(runtime::Integer depth) {
+    if (depth <= 0) {
+        ejcPanic("The depth of a 🚛 must be greater than 0.");
+    }
+    auto queue = Queue::init();
+#ifdef FILES_IO_URING
+    if (std::getenv("EMOJICODE_NO_IO_URING") == nullptr) {
+        queue->backend = KernelQueueBackend::create(static_cast<unsigned>(std::min<runtime::Integer>(depth, 4096)));
+    }
+#endif
+    if (queue->backend == nullptr) {
+        queue->backend = new ThreadPoolBackend();
+    }
+    return queue;
+}
+
+static Operation* enqueue(Queue *queue, Descriptor *file, Data *data, bool write, runtime::Integer offset) {
+    if (queue->backend == nullptr) {
+        ejcPanic("An operation was queued on a closed 🚛.");
+    }
+    auto operation = Operation::init(queue, file, data, write, offset);
+    operation->retain();  // Released by the backend once completed.
+    queue->pending.emplace_back(operation);
+    return operation;
+}
+
+extern "C" Operation* filesQueueRead(Queue *queue, Descriptor *file, runtime::Integer offset, runtime::Integer count) {
+    auto data = Data::init();
+    data->data = runtime::allocate<runtime::Byte>(count);
+    data->count = count;
+    return enqueue(queue, file, data, false, offset);
+}
+
+extern "C" Operation* filesQueueWrite(Queue *queue, Descriptor *file, runtime::Integer offset, Data *data) {
+    data->retain();
+    return enqueue(queue, file, data, true, offset);
+}
+
+extern "C" void filesQueueSubmit(Queue *queue) {
+    queue->submit();
+}
+
+extern "C" void filesQueueWaitAll(Queue *queue) {
+    queue->submit();
+    queue->backend->waitAll();
+}
+
+extern "C" runtime::Boolean filesQueueUsesKernelQueue(Queue *queue) {
+    return queue->backend->usesKernelQueue();
+}
+
+extern "C" void filesQueueDestruct(Queue *queue) {
+    queue->~Queue();
+}
+
+extern "C" void filesQueueClose(Queue *queue) {
+    if (queue->backend == nullptr) {
+        return;
+    }
+    filesQueueWaitAll(queue);
+    delete queue->backend;
+    queue->backend = nullptr;
+}
+
+extern "C" runtime::SimpleError<runtime::Integer> filesOperationWait(Operation *operation) {
+    if (!operation->submitted) {
+        operation->queue->submit();
+    }
+    if (!operation->done) {
+        operation->queue->backend->wait(operation);
+    }
+    if (operation->result < 0) {
+        return { runtime::MakeError, errorEnumFromResult(operation->result) };
+    }
+    return operation->result;
+}
+
+extern "C" runtime::Boolean filesOperationIsDone(Operation *operation) {
+    return operation->done.load();
+}
+
+extern "C" runtime::SimpleOptional<Data*> filesOperationData(Operation *operation) {
+    if (operation->write || !operation->done || operation->result < 0) {
+        return runtime::NoValue;
+    }
+    operation->data->retain();
+    return operation->data;
+}
+
+extern "C" void filesOperationDestruct(Operation *operation) {
+    operation->~Operation();
+}
+
+}  // namespace files
+
+SET_INFO_FOR(files::Descriptor, files, 1f4be)
+SET_INFO_FOR(files::Queue, files, 1f69b)
+SET_INFO_FOR(files::Operation, files, 1f4e9)
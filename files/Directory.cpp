@@ -0,0 +1,212 @@
+//
+// Listing and walking directories.
+//
+
+#include "../s/String.h"
+#include "../s/Task.h"
+#include "../runtime/Runtime.h"
+#include <cerrno>
+#include <string>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using s::String;
+
+namespace files {
+
+runtime::Enum errorEnumFromErrno();
+
+/// The values of 🔖.
+enum class EntryKind : runtime::Enum { File, Directory, SymbolicLink, Other };
+
+static EntryKind kindFromMode(mode_t mode) {
+    if (S_ISREG(mode)) return EntryKind::File;
+    if (S_ISDIR(mode)) return EntryKind::Directory;
+    if (S_ISLNK(mode)) return EntryKind::SymbolicLink;
+    return EntryKind::Other;
+}
+
+class Entry : public runtime::Object<Entry> {
+public:
+    Entry(std::string path, size_t nameOffset, EntryKind kind)
+        : path(std::move(path)), nameOffset(nameOffset), kind(kind) {}
+
+    std::string path;
+    size_t nameOffset;
+    EntryKind kind;
+    /// The size or -1 if lstat() has not been called yet.
+    runtime::Integer size = -1;
+};
+
+/// Creates an entry for *dirent* in the directory at *directory*. The kind of the entry is taken from d_type and only
+/// determined with lstat() if the file system does not provide it. Returns nullptr for `.` and `..`.
+static Entry* makeEntry(const std::string &directory, const dirent *dirent) {
+    auto name = dirent->d_name;
+    if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) {
+        return nullptr;
+    }
+    auto path = directory.back() == '/' ? directory + name : directory + '/' + name;
+    auto nameOffset = path.size() - std::char_traits<char>::length(name);
+    EntryKind kind;
+    switch (dirent->d_type) {
+        case DT_REG:
+            kind = EntryKind::File;
+            break;
+        case DT_DIR:
+            kind = EntryKind::Directory;
+            break;
+        case DT_LNK:
+            kind = EntryKind::SymbolicLink;
+            break;
+        case DT_UNKNOWN: {
+            struct stat st{};
+            kind = lstat(path.c_str(), &st) == 0 ? kindFromMode(st.st_mode) : EntryKind::Other;
+            break;
+        }
+        default:
+            kind = EntryKind::Other;
+            break;
+    }
+    return Entry::init(std::move(path), nameOffset, kind);
+}
+
+extern "C" String* filesEntryName(Entry *entry) {
+    return String::init(entry->path.c_str() + entry->nameOffset);
+}
+
+extern "C" String* filesEntryPath(Entry *entry) {
+    return String::init(entry->path.c_str());
+}
+
+extern "C" runtime::Enum filesEntryKind(Entry *entry) {
+    return static_cast<runtime::Enum>(entry->kind);
+}
+
+extern "C" runtime::SimpleError<runtime::Integer> filesEntrySize(Entry *entry) {
+    if (entry->size < 0) {
+        struct stat st{};
+        if (lstat(entry->path.c_str(), &st) != 0) {
+            return { runtime::MakeError, errorEnumFromErrno() };
+        }
+        entry->size = st.st_size;
+    }
+    return entry->size;
+}
+
+extern "C" void filesEntryDestruct(Entry *entry) {
+    entry->~Entry();
+}
+
+class Directory : public runtime::Object<Directory> {
+public:
+    std::string path;
+    DIR *dir = nullptr;
+    Entry *next = nullptr;
+};
+
+extern "C" runtime::SimpleError<Directory*> filesDirectoryNew(String *path) {
+    auto stdPath = path->stdString();
+    auto dir = opendir(stdPath.c_str());
+    if (dir == nullptr) {
+        return { runtime::MakeError, errorEnumFromErrno() };
+    }
+    auto directory = Directory::init();
+    directory->path = std::move(stdPath);
+    directory->dir = dir;
+    return directory;
+}
+
+extern "C" runtime::Boolean filesDirectoryHasNext(Directory *directory) {
+    if (directory->next != nullptr) {
+        return true;
+    }
+    if (directory->dir == nullptr) {
+        return false;
+    }
+    while (auto dirent = readdir(directory->dir)) {
+        if (auto entry = makeEntry(directory->path, dirent)) {
+            directory->next = entry;
+            return true;
+        }
+    }
+    closedir(directory->dir);
+    directory->dir = nullptr;
+    return false;
+}
+
+extern "C" Entry* filesDirectoryNext(Directory *directory) {
+    if (!filesDirectoryHasNext(directory)) {
+        ejcPanic("🔽 was called on 📂 although 🔽❓ returned 👎.");
+    }
+    auto entry = directory->next;
+    directory->next = nullptr;
+    return entry;
+}
+
+extern "C" void filesDirectoryClose(Directory *directory) {
+    if (directory->dir != nullptr) {
+        closedir(directory->dir);
+        directory->dir = nullptr;
+    }
+    if (directory->next != nullptr) {
+        directory->next->release();
+        directory->next = nullptr;
+    }
+}
+
+extern "C" void filesDirectoryDestruct(Directory *directory) {
+    directory->~Directory();
+}
+
+/// Walks a directory hierarchy with tasks on the worker threads that run 🎬. Every directory is listed by a task of
+/// its own, which starts a task for every subdirectory it finds.
+class Walker {
+public:
+    explicit Walker(runtime::Callable<runtime::Boolean, Entry*> visit) : visit_(visit) {}
+
+    void run(std::string root) {
+        list(std::move(root));
+        tasks_.wait();
+    }
+
+private:
+    void list(std::string path) {
+        tasks_.run([this, path] {
+            auto dir = opendir(path.c_str());
+            if (dir == nullptr) {
+                return;
+            }
+            while (auto dirent = readdir(dir)) {
+                auto entry = makeEntry(path, dirent);
+                if (entry == nullptr) {
+                    continue;
+                }
+                if (visit_(entry) && entry->kind == EntryKind::Directory) {
+                    list(entry->path);
+                }
+                entry->release();
+            }
+            closedir(dir);
+        });
+    }
+
+    runtime::Callable<runtime::Boolean, Entry*> visit_;
+    s::TaskGroup tasks_;
+};
+
+extern "C" runtime::SimpleOptional<runtime::Enum> filesFsWalk(String *path,
+                                                              runtime::Callable<runtime::Boolean, Entry*> visit) {
+    auto root = path->stdString();
+    auto dir = opendir(root.c_str());
+    if (dir == nullptr) {
+        return errorEnumFromErrno();
+    }
+    closedir(dir);
+    Walker(visit).run(std::move(root));
+    return runtime::NoValue;
+}
+
+}  // namespace files
+
+SET_INFO_FOR(files::Entry, files, 1f4cb)
+SET_INFO_FOR(files::Directory, files, 1f4c2)
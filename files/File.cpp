@@ -9,6 +9,10 @@
 #include <ios>
 #include <iostream>
 #include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using s::String;
 using s::Data;
@@ -86,6 +90,89 @@ extern "C" runtime::SimpleError<Data*> filesFileReadFile(runtime::ClassInfo*, St
     return returnErrorIfFailed(data, file);
 }
 
+/// Translates a value of 🔦 into the corresponding posix_madvise() advice.
+static int adviceFromEnum(runtime::Enum access) {
+    switch (access) {
+        case 1:
+            return POSIX_MADV_SEQUENTIAL;
+        case 2:
+            return POSIX_MADV_RANDOM;
+        case 3:
+            return POSIX_MADV_WILLNEED;
+        default:
+            return POSIX_MADV_NORMAL;
+    }
+}
+
+static size_t pageSize() {
+    static auto size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+/// A mapped file is preceded by one anonymous page. The length of the whole mapping is stored at its beginning and the
+/// deallocator and control block pointer in the last bytes, directly in front of the file contents.
+static int8_t* headerOfMapping(int8_t *base) {
+    return base + pageSize() - sizeof(runtime::internal::ControlBlock *);
+}
+
+static void unmapFile(int8_t *header) {
+    auto base = header - (pageSize() - sizeof(runtime::internal::ControlBlock *));
+    munmap(base, *reinterpret_cast<size_t *>(base));
+}
+
+extern "C" runtime::SimpleError<Data*> filesFileMapFile(runtime::ClassInfo*, String *path, runtime::Enum access) {
+    int fd = open(path->stdString().c_str(), O_RDONLY);
+    if (fd == -1) {
+        return { runtime::MakeError, errorEnumFromErrno() };
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        auto error = errorEnumFromErrno();
+        close(fd);
+        return { runtime::MakeError, error };
+    }
+
+    if (st.st_size == 0) {
+        close(fd);
+        auto data = Data::init();
+        data->data = runtime::allocate<runtime::Byte>(0);
+        data->count = 0;
+        return data;
+    }
+
+    auto length = pageSize() + static_cast<size_t>(st.st_size);
+    auto base = static_cast<int8_t *>(mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (base == MAP_FAILED) {
+        auto error = errorEnumFromErrno();
+        close(fd);
+        return { runtime::MakeError, error };
+    }
+    if (mmap(base + pageSize(), st.st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        auto error = errorEnumFromErrno();
+        close(fd);
+        munmap(base, length);
+        return { runtime::MakeError, error };
+    }
+    close(fd);
+    *reinterpret_cast<size_t *>(base) = length;
+    posix_madvise(base + pageSize(), st.st_size, adviceFromEnum(access));
+
+    auto data = Data::init();
+    data->data = runtime::adoptMemory<runtime::Byte>(headerOfMapping(base), unmapFile);
+    data->count = st.st_size;
+    return data;
+}
+
+extern "C" void filesFileAdvise(runtime::ClassInfo*, Data *data, runtime::Enum access) {
+    auto begin = reinterpret_cast<uintptr_t>(data->data.get());
+    auto end = begin + data->count;
+    auto alignedBegin = (begin + pageSize() - 1) & ~(pageSize() - 1);
+    if (alignedBegin >= end) {
+        return;
+    }
+    posix_madvise(reinterpret_cast<void *>(alignedBegin), end - alignedBegin, adviceFromEnum(access));
+}
+
 extern "C" runtime::SimpleOptional<runtime::Enum> filesFileWriteToFile(runtime::ClassInfo*, String *path, Data *data) {
     auto file = std::ofstream(path->stdString().c_str(), std::ios_base::out);
     file.write(reinterpret_cast<char *>(data->data.get()), data->count);
@@ -0,0 +1,298 @@
+//
+// Iterators over the lines and chunks of a file.
+//
+
+#include "../s/String.h"
+#include "../runtime/Runtime.h"
+#include "../s/Data.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using s::String;
+using s::Data;
+
+namespace files {
+
+runtime::Enum errorEnum(int error);
+runtime::Enum errorEnumFromErrno();
+
+/// Reads a file into a buffer that is reused for the whole file. The buffer only grows if a line or chunk does not fit.
+class BufferedReader {
+public:
+    static constexpr size_t kInitialCapacity = 64 * 1024;
+
+    bool open(String *path) {
+        fd_ = ::open(path->stdString().c_str(), O_RDONLY);
+        return fd_ != -1;
+    }
+
+    void close() {
+        if (fd_ != -1) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        std::free(buffer_);
+        buffer_ = nullptr;
+        capacity_ = begin_ = end_ = 0;
+    }
+
+    /// Returns the first unconsumed byte.
+    const uint8_t* begin() const { return buffer_ + begin_; }
+    /// Returns the number of unconsumed bytes.
+    size_t available() const { return end_ - begin_; }
+    void consume(size_t n) { begin_ += n; }
+
+    /// Returns the errno value of the error that stopped reading or 0 if no error occurred.
+    int error() const { return error_; }
+
+    /// Reads more bytes behind the unconsumed bytes. Returns false if the end of the file has been reached or reading
+    /// failed, in which case error() tells why.
+    bool fill() {
+        if (fd_ == -1) {
+            return false;
+        }
+        if (begin_ > 0) {
+            std::memmove(buffer_, buffer_ + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+        if (end_ == capacity_) {
+            auto capacity = capacity_ == 0 ? kInitialCapacity : capacity_ * 2;
+            auto buffer = static_cast<uint8_t *>(std::realloc(buffer_, capacity));
+            if (buffer == nullptr) {
+                stop(ENOMEM);
+                return false;
+            }
+            buffer_ = buffer;
+            capacity_ = capacity;
+        }
+        ssize_t n;
+        do {
+            n = ::read(fd_, buffer_ + end_, capacity_ - end_);
+        } while (n == -1 && errno == EINTR);
+        if (n <= 0) {
+            stop(n == -1 ? errno : 0);
+            return false;
+        }
+        end_ += n;
+        return true;
+    }
+
+private:
+    /// Closes the file after reading failed with @c error or reached the end.
+    void stop(int error) {
+        error_ = error;
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    int fd_ = -1;
+    int error_ = 0;
+    uint8_t *buffer_ = nullptr;
+    size_t capacity_ = 0;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+};
+
+/// Returns the number of bytes of the UTF-8 sequence starting with *lead* or 0 if *lead* cannot start a sequence.
+static size_t sequenceLength(uint8_t lead) {
+    if (lead < 0x80) return 1;
+    if ((lead & 0xE0) == 0xC0) return lead >= 0xC2 ? 2 : 0;
+    if ((lead & 0xF0) == 0xE0) return 3;
+    if ((lead & 0xF8) == 0xF0) return lead <= 0xF4 ? 4 : 0;
+    return 0;
+}
+
+/// Returns whether *byte* can follow *lead* as second byte of a sequence. Besides being a continuation byte it must not
+/// make the sequence an overlong encoding (E0 80–9F, F0 80–8F), a surrogate (ED A0–BF) or greater than U+10FFFF
+/// (F4 90–BF).
+static bool isValidSecondByte(uint8_t lead, uint8_t byte) {
+    switch (lead) {
+        case 0xE0:
+            return byte >= 0xA0 && byte <= 0xBF;
+        case 0xED:
+            return byte >= 0x80 && byte <= 0x9F;
+        case 0xF0:
+            return byte >= 0x90 && byte <= 0xBF;
+        case 0xF4:
+            return byte >= 0x80 && byte <= 0x8F;
+        default:
+            return (byte & 0xC0) == 0x80;
+    }
+}
+
+/// Decodes the UTF-8 in *bytes* into *characters* and returns the number of characters. Every byte that is not part of
+/// a valid sequence is decoded to U+FFFD. If *characters* is nullptr the characters are only counted.
+static size_t decode(const uint8_t *bytes, size_t count, String::Character *characters) {
+    size_t n = 0;
+    for (size_t i = 0; i < count; n++) {
+        auto length = sequenceLength(bytes[i]);
+        String::Character character = length == 1 ? bytes[i] : bytes[i] & (0x7F >> length);
+        for (size_t j = 1; j < length; j++) {
+            if (i + j >= count || (j == 1 ? !isValidSecondByte(bytes[i], bytes[i + 1])
+                                          : (bytes[i + j] & 0xC0) != 0x80)) {
+                length = 0;
+                break;
+            }
+            character = (character << 6) | (bytes[i + j] & 0x3F);
+        }
+        if (length == 0) {
+            character = 0xFFFD;
+            length = 1;
+        }
+        if (characters != nullptr) {
+            characters[n] = character;
+        }
+        i += length;
+    }
+    return n;
+}
+
+class Lines : public runtime::Object<Lines> {
+public:
+    BufferedReader reader;
+    String *next = nullptr;
+};
+
+class Chunks : public runtime::Object<Chunks> {
+public:
+    BufferedReader reader;
+    runtime::Integer size;
+    Data *next = nullptr;
+};
+
+extern "C" runtime::SimpleError<Lines*> filesLinesNew(String *path) {
+    auto lines = Lines::init();
+    if (!lines->reader.open(path)) {
+        return { runtime::MakeError, errorEnumFromErrno() };
+    }
+    return lines;
+}
+
+/// Creates a string from the line of *length* bytes at the beginning of the buffer without its line terminator.
+static String* makeLine(const uint8_t *bytes, size_t length) {
+    if (length > 0 && bytes[length - 1] == '\r') {
+        length--;
+    }
+    auto string = String::init();
+    string->count = decode(bytes, length, nullptr);
+    string->characters = runtime::allocate<String::Character>(string->count);
+    decode(bytes, length, string->characters.get());
+    return string;
+}
+
+extern "C" runtime::Boolean filesLinesHasNext(Lines *lines) {
+    if (lines->next != nullptr) {
+        return true;
+    }
+    auto &reader = lines->reader;
+    size_t searched = 0;
+    while (true) {
+        auto newline = reader.available() > searched ?
+                std::memchr(reader.begin() + searched, '\n', reader.available() - searched) : nullptr;
+        if (newline != nullptr) {
+            auto length = static_cast<const uint8_t *>(newline) - reader.begin();
+            lines->next = makeLine(reader.begin(), length);
+            reader.consume(length + 1);
+            return true;
+        }
+        searched = reader.available();
+        if (!reader.fill()) {
+            break;
+        }
+    }
+    if (reader.available() == 0) {
+        return false;
+    }
+    lines->next = makeLine(reader.begin(), reader.available());
+    reader.consume(reader.available());
+    return true;
+}
+
+extern "C" String* filesLinesNext(Lines *lines) {
+    if (!filesLinesHasNext(lines)) {
+        ejcPanic("🔽 was called on 🗒 although 🔽❓ returned 👎.");
+    }
+    auto line = lines->next;
+    lines->next = nullptr;
+    return line;
+}
+
+extern "C" runtime::SimpleOptional<runtime::Enum> filesLinesError(Lines *lines) {
+    if (lines->reader.error() == 0) {
+        return runtime::NoValue;
+    }
+    return errorEnum(lines->reader.error());
+}
+
+extern "C" void filesLinesClose(Lines *lines) {
+    lines->reader.close();
+    if (lines->next != nullptr) {
+        lines->next->release();
+        lines->next = nullptr;
+    }
+}
+
+extern "C" runtime::SimpleError<Chunks*> filesChunksNew(String *path, runtime::Integer size) {
+    if (size <= 0) {
+        ejcPanic("The size of the chunks of 🍱 must be greater than 0.");
+    }
+    auto chunks = Chunks::init();
+    chunks->size = size;
+    if (!chunks->reader.open(path)) {
+        return { runtime::MakeError, errorEnumFromErrno() };
+    }
+    return chunks;
+}
+
+extern "C" runtime::Boolean filesChunksHasNext(Chunks *chunks) {
+    if (chunks->next != nullptr) {
+        return true;
+    }
+    auto &reader = chunks->reader;
+    auto size = static_cast<size_t>(chunks->size);
+    while (reader.available() < size && reader.fill()) {}
+    if (reader.available() == 0) {
+        return false;
+    }
+    auto data = Data::init();
+    data->count = std::min(size, reader.available());
+    data->data = runtime::allocate<runtime::Byte>(data->count);
+    std::memcpy(data->data.get(), reader.begin(), data->count);
+    reader.consume(data->count);
+    chunks->next = data;
+    return true;
+}
+
+extern "C" Data* filesChunksNext(Chunks *chunks) {
+    if (!filesChunksHasNext(chunks)) {
+        ejcPanic("🔽 was called on 🍱 although 🔽❓ returned 👎.");
+    }
+    auto data = chunks->next;
+    chunks->next = nullptr;
+    return data;
+}
+
+extern "C" runtime::SimpleOptional<runtime::Enum> filesChunksError(Chunks *chunks) {
+    if (chunks->reader.error() == 0) {
+        return runtime::NoValue;
+    }
+    return errorEnum(chunks->reader.error());
+}
+
+extern "C" void filesChunksClose(Chunks *chunks) {
+    chunks->reader.close();
+    if (chunks->next != nullptr) {
+        chunks->next->release();
+        chunks->next = nullptr;
+    }
+}
+
+}  // namespace files
+
+SET_INFO_FOR(files::Lines, files, 1f5d2)
+SET_INFO_FOR(files::Chunks, files, 1f371)
@@ -15,8 +15,8 @@ namespace files {
 
 using s::String;
 
-runtime::Enum errorEnumFromErrno() {
-    switch (errno) {
+runtime::Enum errorEnum(int error) {
+    switch (error) {
         case EACCES:
             return 1;
         case EEXIST:
@@ -40,6 +40,10 @@ runtime::Enum errorEnumFromErrno() {
     }
 }
 
+runtime::Enum errorEnumFromErrno() {
+    return errorEnum(errno);
+}
+
 runtime::SimpleOptional<runtime::Enum> returnOptional(bool success) {
     if (success) {
         return runtime::NoValue;
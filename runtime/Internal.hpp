@@ -6,6 +6,7 @@
 #define EMOJICODE_INTERNAL_HPP
 
 #include <atomic>
+#include <cstdint>
 
 namespace runtime {
 
@@ -15,8 +16,42 @@ namespace internal {
 extern int argc;
 extern char **argv;
 
+struct ThreadRecord;
+
+/// Returns the record of the calling thread, which is created on first use.
+ThreadRecord* currentThread();
+/// Like currentThread() but also counts a new control block that refers to the record until its counts are merged.
+/// Returns nullptr if the calling thread is exiting or has exited.
+ThreadRecord* ownNewBlock();
+
+/// Set in ControlBlock::sharedCount once the counts have been merged.
+constexpr int64_t kMerged = 1;
+/// Set in ControlBlock::sharedCount while the object is queued for the owner to merge.
+constexpr int64_t kQueued = 2;
+/// Set in ControlBlock::sharedCount of memory made reference counted by runtime::adoptMemory, which is freed by the
+/// Deallocator stored in front of it.
+constexpr int64_t kAdopted = 4;
+constexpr int64_t kSharedOne = 8;
+
+/// The reference count of a heap object. It is biased towards the thread that created the object: As long as this
+/// thread, the owner, holds references it counts them in biasedCount without atomic instructions. Other threads count
+/// their references in sharedCount atomically, which becomes negative if they release references the owner handed
+/// to them. Once the owner has no references left the counts are merged and all threads use sharedCount from then on.
 struct ControlBlock {
-    std::atomic_int strongCount{1};
+    ControlBlock() : owner(ownNewBlock()) {
+        if (owner.load(std::memory_order_relaxed) == nullptr) {
+            // A thread that is exiting counts all its references in sharedCount.
+            biasedCount = 0;
+            sharedCount.store(kSharedOne | kMerged, std::memory_order_relaxed);
+        }
+    }
+    explicit ControlBlock(ThreadRecord *owner) : owner(owner) {}
+
+    /// The owner or nullptr if the counts have been merged.
+    std::atomic<ThreadRecord *> owner;
+    int64_t biasedCount = 1;
+    /// The shared count times kSharedOne, whose lower bits hold the flags kMerged, kQueued and kAdopted.
+    std::atomic<int64_t> sharedCount{0};
     std::atomic_int weakCount{0};
 };
 
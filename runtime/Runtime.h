@@ -19,12 +19,24 @@ namespace runtime {
 namespace internal {
 struct ControlBlock;
 ControlBlock* newControlBlock();
+/// Returns a control block for memory passed to runtime::adoptMemory.
+ControlBlock* newAdoptedControlBlock();
 struct Capture;
 }
+
+/// Frees memory made reference counted by adoptMemory.
+using Deallocator = void (*)(int8_t *pointer);
 }
 
 extern "C" int8_t* ejcAlloc(int64_t size);
 extern "C" [[noreturn]] void ejcPanic(const char *message);
+/// Allocates the frame of the coroutine of an ⏯ function.
+extern "C" int8_t* ejcCoroutineAlloc(int64_t size);
+/// Frees a coroutine frame allocated with ejcCoroutineAlloc.
+extern "C" void ejcCoroutineFree(int8_t *frame);
+/// Resumes the suspended coroutine of an ⏯ function. A native ⏯ function must call this exactly once with the
+/// handle it received, for instance from a task, after it completed.
+extern "C" void ejcCoroutineResume(int8_t *coroutine);
 
 namespace runtime {
 
@@ -62,6 +74,8 @@ template <typename T>
 class MemoryPointer {
     template <typename TA>
     friend inline MemoryPointer<TA> allocate(int64_t n);
+    template <typename TA>
+    friend inline MemoryPointer<TA> adoptMemory(int8_t *pointer, Deallocator deallocate);
 public:
     MemoryPointer() {}
     T* get() const {
@@ -81,6 +95,16 @@ inline MemoryPointer<T> allocate(int64_t n = 1) {
     return MemoryPointer<T>(ejcAlloc(sizeof(T) * n + sizeof(runtime::internal::ControlBlock *)));
 }
 
+/// Makes memory that was not allocated with allocate() reference counted. *pointer* must point to space for a pointer
+/// directly in front of the memory, which must itself be preceded by space for a Deallocator. *deallocate* is called
+/// with *pointer* once the last reference has been released.
+template <typename T>
+inline MemoryPointer<T> adoptMemory(int8_t *pointer, Deallocator deallocate) {
+    reinterpret_cast<Deallocator *>(pointer)[-1] = deallocate;
+    *reinterpret_cast<runtime::internal::ControlBlock **>(pointer) = internal::newAdoptedControlBlock();
+    return MemoryPointer<T>(pointer);
+}
+
 template <typename Subclass>
 class Object {
 public:
@@ -12,16 +12,125 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
-runtime::internal::ControlBlock ejcIgnoreBlock;
+runtime::internal::ControlBlock ejcIgnoreBlock(nullptr);
 
 int runtime::internal::argc;
 char **runtime::internal::argv;
 
+namespace runtime {
+namespace internal {
+
+/// Determines how a heap allocation is destroyed once its reference count has reached zero.
+enum class Allocation { Object, Capture, Memory };
+
+struct QueuedObject {
+    ControlBlock *block;
+    void *object;
+    Allocation allocation;
+};
+
+/// A record outlives its thread as long as control blocks that have not been merged refer to it.
+struct ThreadRecord {
+    std::mutex mutex;
+    /// Objects owned by this thread whose shared count became negative. The owner must merge their counts as it might
+    /// never release them again.
+    std::vector<QueuedObject> queue;
+    std::atomic_bool hasQueue{false};
+    bool exited = false;
+    /// The number of unmerged control blocks owned by this thread plus one for the thread itself. The record is deleted
+    /// once it drops to zero. Until the thread exits only the thread changes it, so it does so without atomic
+    /// read-modify-write instructions.
+    std::atomic<int64_t> references{1};
+};
+
+}  // namespace internal
+}  // namespace runtime
+
+using runtime::internal::Allocation;
+using runtime::internal::ControlBlock;
+using runtime::internal::QueuedObject;
+using runtime::internal::ThreadRecord;
+using runtime::internal::kAdopted;
+using runtime::internal::kMerged;
+using runtime::internal::kQueued;
+using runtime::internal::kSharedOne;
+
+static void mergeQueue(ThreadRecord *thread);
+
+static thread_local ThreadRecord *currentThreadRecord = nullptr;
+
+/// Records are only deleted while this mutex is held, so that a thread can look at the owner of a control block without
+/// the owner being deleted.
+static std::mutex& recordsMutex() {
+    static auto mutex = new std::mutex;
+    return *mutex;
+}
+
+static void releaseRecord(ThreadRecord *thread) {
+    if (thread->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(recordsMutex());
+        delete thread;
+    }
+}
+
+/// Stands in for the record of a thread that has exited. No control block is owned by it, so retain() and release()
+/// count all references of such a thread in the shared count.
+static ThreadRecord* exitedThreadRecord() {
+    static auto record = [] {
+        auto record = new ThreadRecord;
+        record->exited = true;
+        return record;
+    }();
+    return record;
+}
+
+/// Merges the counts of all objects queued for a thread when the thread exits.
+struct ThreadExit {
+    ~ThreadExit() {
+        auto thread = currentThreadRecord;
+        {
+            std::lock_guard<std::mutex> lock(thread->mutex);
+            thread->exited = true;
+        }
+        mergeQueue(thread);
+        // thread_local destructors that run later, like that of the thread local storage, can still retain and release
+        // objects. A new record would never be released, as this destructor does not run again.
+        currentThreadRecord = exitedThreadRecord();
+        releaseRecord(thread);
+    }
+};
+
+ThreadRecord* runtime::internal::currentThread() {
+    if (currentThreadRecord == nullptr) {
+        currentThreadRecord = new ThreadRecord;
+        static thread_local ThreadExit threadExit;
+        (void)threadExit;
+    }
+    return currentThreadRecord;
+}
+
+ThreadRecord* runtime::internal::ownNewBlock() {
+    auto thread = currentThread();
+    if (thread->exited) {
+        return nullptr;
+    }
+    thread->references.store(thread->references.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return thread;
+}
+
 runtime::internal::ControlBlock* runtime::internal::newControlBlock() {
     return new runtime::internal::ControlBlock;
 }
 
+runtime::internal::ControlBlock* runtime::internal::newAdoptedControlBlock() {
+    auto block = new runtime::internal::ControlBlock;
+    block->sharedCount.fetch_or(runtime::internal::kAdopted, std::memory_order_relaxed);
+    return block;
+}
+
 extern "C" runtime::Integer fn_1f3c1();
 
 extern "C" int8_t* ejcAlloc(runtime::Integer size) {
@@ -30,6 +139,146 @@ extern "C" int8_t* ejcAlloc(runtime::Integer size) {
     return static_cast<int8_t*>(ptr);
 }
 
+extern "C" int8_t* ejcCoroutineAlloc(runtime::Integer size) {
+    return static_cast<int8_t*>(malloc(size));
+}
+
+extern "C" void ejcCoroutineFree(int8_t *frame) {
+    free(frame);
+}
+
+extern "C" void ejcCoroutineResume(int8_t *coroutine) {
+    // The frame of a switch-resumed coroutine begins with a pointer to its resume function.
+    (*reinterpret_cast<void (**)(int8_t *)>(coroutine))(coroutine);
+}
+
+static void destroy(const QueuedObject &object) {
+    switch (object.allocation) {
+        case Allocation::Object: {
+            auto instance = static_cast<runtime::Object<void> *>(object.object);
+            instance->classInfo()->dispatch<void>(0, instance);
+            break;
+        }
+        case Allocation::Capture: {
+            auto capture = static_cast<runtime::internal::Capture *>(object.object);
+            capture->deinit(capture);
+            break;
+        }
+        case Allocation::Memory:
+            if ((object.block->sharedCount.load(std::memory_order_relaxed) & kAdopted) != 0) {
+                auto memory = static_cast<int8_t *>(object.object);
+                delete object.block;
+                reinterpret_cast<runtime::Deallocator *>(memory)[-1](memory);
+                return;
+            }
+            break;
+    }
+    delete object.block;
+    free(object.object);
+}
+
+/// Adds the biased count to the shared count and removes the bias. Must only be called by the owner or after the
+/// owner exited.
+static void merge(const QueuedObject &object) {
+    auto block = object.block;
+    auto owner = block->owner.load(std::memory_order_relaxed);
+    auto biased = block->biasedCount * kSharedOne + kMerged;
+    block->biasedCount = 0;
+    block->owner.store(nullptr, std::memory_order_relaxed);
+    if (((block->sharedCount.fetch_add(biased, std::memory_order_acq_rel) + biased) & ~kAdopted) == kMerged) {
+        destroy(object);
+    }
+    if (owner == currentThreadRecord && !owner->exited) {
+        owner->references.store(owner->references.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+    else {
+        releaseRecord(owner);
+    }
+}
+
+/// Removes the queued flag and destroys the object if no references are left.
+static void unqueue(const QueuedObject &object) {
+    if ((object.block->sharedCount.fetch_and(~kQueued, std::memory_order_acq_rel) & ~(kQueued | kAdopted)) == kMerged) {
+        destroy(object);
+    }
+}
+
+static void mergeQueue(ThreadRecord *thread) {
+    std::vector<QueuedObject> queue;
+    {
+        std::lock_guard<std::mutex> lock(thread->mutex);
+        queue.swap(thread->queue);
+        thread->hasQueue.store(false, std::memory_order_relaxed);
+    }
+    for (auto &object : queue) {
+        if (object.block->owner.load(std::memory_order_relaxed) == thread) {
+            merge(object);
+        }
+        unqueue(object);
+    }
+}
+
+/// Called by the thread that made the shared count of an object negative and set kQueued.
+static void enqueue(const QueuedObject &object) {
+    {
+        std::lock_guard<std::mutex> recordsLock(recordsMutex());
+        auto owner = object.block->owner.load(std::memory_order_acquire);
+        if (owner != nullptr) {
+            std::lock_guard<std::mutex> lock(owner->mutex);
+            if (!owner->exited) {
+                owner->queue.emplace_back(object);
+                owner->hasQueue.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+    // Either the owner merged the counts in the meantime or it exited, in which case nobody else merges them.
+    if (object.block->owner.load(std::memory_order_acquire) != nullptr) {
+        merge(object);
+    }
+    unqueue(object);
+}
+
+static void retain(ControlBlock *block) {
+    if (block->owner.load(std::memory_order_relaxed) == runtime::internal::currentThread()) {
+        block->biasedCount++;
+        return;
+    }
+    block->sharedCount.fetch_add(kSharedOne, std::memory_order_relaxed);
+}
+
+static void release(const QueuedObject &object) {
+    auto thread = runtime::internal::currentThread();
+    if (thread->hasQueue.load(std::memory_order_relaxed)) {
+        mergeQueue(thread);
+    }
+
+    auto block = object.block;
+    if (block->owner.load(std::memory_order_relaxed) == thread) {
+        if (--block->biasedCount == 0) {
+            merge(object);
+        }
+        return;
+    }
+
+    auto value = block->sharedCount.fetch_sub(kSharedOne, std::memory_order_acq_rel) - kSharedOne;
+    if ((value & ~kAdopted) == kMerged) {
+        destroy(object);
+        return;
+    }
+    if (value < 0 && (value & (kMerged | kQueued)) == 0) {
+        auto previous = block->sharedCount.fetch_or(kQueued, std::memory_order_acq_rel);
+        if ((previous & kQueued) != 0) {
+            return;
+        }
+        if ((previous & kMerged) != 0) {
+            unqueue(object);
+            return;
+        }
+        enqueue(object);
+    }
+}
+
 extern "C" void ejcRetain(runtime::Object<void> *object) {
     runtime::internal::ControlBlock *controlBlock = object->controlBlock();
     if (controlBlock == nullptr) {
@@ -38,7 +287,7 @@ extern "C" void ejcRetain(runtime::Object<void> *object) {
         return;
     }
     if (controlBlock == &ejcIgnoreBlock) return;
-    controlBlock->strongCount++;
+    retain(controlBlock);
 }
 
 bool releaseLocal(void *object) {
@@ -56,13 +305,7 @@ extern "C" void ejcRelease(runtime::Object<void> *object) {
         return;
     }
     if (controlBlock == &ejcIgnoreBlock) return;
-
-    controlBlock->strongCount--;
-    if (controlBlock->strongCount != 0) return;
-
-    object->classInfo()->dispatch<void>(0, object);
-    delete controlBlock;
-    free(object);
+    release(QueuedObject { controlBlock, object, Allocation::Object });
 }
 
 extern "C" void ejcReleaseCapture(runtime::internal::Capture *capture) {
@@ -74,13 +317,7 @@ extern "C" void ejcReleaseCapture(runtime::internal::Capture *capture) {
         return;
     }
     if (controlBlock == &ejcIgnoreBlock) return;
-
-    controlBlock->strongCount--;
-    if (controlBlock->strongCount != 0) return;
-
-    capture->deinit(capture);
-    delete controlBlock;
-    free(capture);
+    release(QueuedObject { controlBlock, capture, Allocation::Capture });
 }
 
 extern "C" void ejcReleaseMemory(runtime::Object<void> *object) {
@@ -90,12 +327,7 @@ extern "C" void ejcReleaseMemory(runtime::Object<void> *object) {
         return;
     }
     if (controlBlock == &ejcIgnoreBlock) return;
-
-    controlBlock->strongCount--;
-    if (controlBlock->strongCount != 0) return;
-
-    delete controlBlock;
-    free(object);
+    release(QueuedObject { controlBlock, object, Allocation::Memory });
 }
 
 extern "C" bool ejcInheritsFrom(runtime::ClassInfo *classInfo, runtime::ClassInfo *from) {
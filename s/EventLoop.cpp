@@ -0,0 +1,362 @@
+#include "EventLoop.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <cerrno>
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+namespace s {
+
+/// Waits for file descriptors and timers on a thread of its own and runs the callbacks of the ones that are ready as
+/// tasks. The thread sleeps in epoll_wait() (or poll() where there is no epoll) until a descriptor becomes ready, the
+/// next timer expires or another thread registers something new, which it signals by writing to a pipe.
+class EventLoop {
+public:
+    /// What is run once a timer expires or a descriptor becomes ready: Either a callable, which is retained until it
+    /// has been called, or the suspended coroutine of an ⏯ function.
+    struct Continuation {
+        Continuation() = default;
+        explicit Continuation(runtime::Callable<void> callable) : callable(callable) { callable.retain(); }
+        explicit Continuation(int8_t *coroutine) : coroutine(coroutine) {}
+
+        /// Runs the continuation as a task.
+        void run() const {
+            if (coroutine != nullptr) {
+                resumeTask(coroutine);
+            }
+            else {
+                runTask(callable);
+                callable.release();
+            }
+        }
+
+        /// Gives up the continuation without running it. A coroutine is resumed nonetheless, as it could never
+        /// complete otherwise.
+        void discard() const {
+            if (coroutine != nullptr) {
+                resumeTask(coroutine);
+            }
+            else {
+                callable.release();
+            }
+        }
+
+        runtime::Callable<void> callable;
+        int8_t *coroutine = nullptr;
+    };
+
+    static EventLoop& shared() {
+        static auto loop = new EventLoop();
+        return *loop;
+    }
+
+    /// @returns The identifier of the timer, which can be passed to cancel().
+    runtime::Integer after(runtime::Integer mcs, Continuation continuation) {
+        runtime::Integer id;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            id = nextTimer_++;
+            auto due = Clock::now() + std::chrono::microseconds(mcs);
+            timers_.emplace(TimerKey(due, id), continuation);
+            timerDues_.emplace(id, due);
+        }
+        wakeUp();
+        return id;
+    }
+
+    /// Removes the timer @c id and discards its continuation.
+    /// @returns False if the timer has already expired or been cancelled.
+    bool cancel(runtime::Integer id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto due = timerDues_.find(id);
+        if (due == timerDues_.end()) {
+            return false;
+        }
+        auto timer = timers_.find(TimerKey(due->second, id));
+        timer->second.discard();
+        timers_.erase(timer);
+        timerDues_.erase(due);
+        return true;
+    }
+
+    void watch(int descriptor, bool write, Continuation continuation) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &watcher = watchers_[descriptor];
+        auto &slot = write ? watcher.writer : watcher.reader;
+        if (slot.waiting) {
+            slot.continuation.discard();
+        }
+        slot.waiting = true;
+        slot.continuation = continuation;
+        arm(descriptor, watcher);
+    }
+
+    /// Discards the continuations waiting for @c descriptor and stops watching it.
+    void forget(int descriptor) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = watchers_.find(descriptor);
+        if (it == watchers_.end()) {
+            return;
+        }
+        for (auto slot : { &it->second.reader, &it->second.writer }) {
+            if (slot->waiting) {
+                slot->continuation.discard();
+            }
+        }
+        watchers_.erase(it);
+        disarm(descriptor);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    /// Timers are ordered by their due time and then by the order in which they were registered.
+    using TimerKey = std::pair<Clock::time_point, runtime::Integer>;
+
+    struct Slot {
+        bool waiting = false;
+        Continuation continuation;
+    };
+
+    struct Watcher {
+        Slot reader;
+        Slot writer;
+    };
+
+    EventLoop() {
+        if (pipe(pipe_) == 0) {
+            fcntl(pipe_[0], F_SETFL, O_NONBLOCK);
+            fcntl(pipe_[1], F_SETFL, O_NONBLOCK);
+        }
+#ifdef __linux__
+        epoll_ = epoll_create1(0);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = pipe_[0];
+        epoll_ctl(epoll_, EPOLL_CTL_ADD, pipe_[0], &event);
+#endif
+        std::thread([this]() { run(); }).detach();
+    }
+
+    void wakeUp() {
+        char byte = 0;
+        write(pipe_[1], &byte, 1);
+    }
+
+    void drainPipe() {
+        char buffer[64];
+        while (read(pipe_[0], buffer, sizeof(buffer)) > 0) {}
+    }
+
+    void run() {
+        while (true) {
+            std::vector<Continuation> ready;
+            int timeout = expireTimers(ready);
+            for (auto &continuation : ready) {
+                continuation.run();
+            }
+            ready.clear();
+            wait(timeout, ready);
+            for (auto &continuation : ready) {
+                continuation.run();
+            }
+        }
+    }
+
+    /// Moves the continuations of all expired timers to @c ready.
+    /// @returns The number of milliseconds until the next timer expires, but at most INT_MAX, or -1 if there is no
+    /// timer.
+    int expireTimers(std::vector<Continuation> &ready) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        while (!timers_.empty() && timers_.begin()->first.first <= now) {
+            auto timer = timers_.begin();
+            ready.emplace_back(timer->second);
+            timerDues_.erase(timer->first.second);
+            timers_.erase(timer);
+        }
+        if (timers_.empty()) {
+            return -1;
+        }
+        auto due = timers_.begin()->first.first;
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(due - now).count();
+        return static_cast<int>(std::min<decltype(remaining)>((remaining + 999) / 1000, INT_MAX));
+    }
+
+    /// Takes the continuation out of @c slot and appends it to @c ready if the slot is waiting.
+    static void fire(Slot &slot, std::vector<Continuation> &ready) {
+        if (slot.waiting) {
+            slot.waiting = false;
+            ready.emplace_back(slot.continuation);
+        }
+    }
+
+#ifdef __linux__
+    /// Makes epoll report the events the slots of @c watcher wait for once. @c mutex_ must be held.
+    void arm(int descriptor, const Watcher &watcher) {
+        epoll_event event{};
+        event.events = EPOLLONESHOT;
+        if (watcher.reader.waiting) {
+            event.events |= EPOLLIN;
+        }
+        if (watcher.writer.waiting) {
+            event.events |= EPOLLOUT;
+        }
+        event.data.fd = descriptor;
+        // A descriptor that was closed since it was last armed has been removed from the epoll set implicitly.
+        if (epoll_ctl(epoll_, EPOLL_CTL_MOD, descriptor, &event) == -1 && errno == ENOENT) {
+            epoll_ctl(epoll_, EPOLL_CTL_ADD, descriptor, &event);
+        }
+    }
+
+    /// Removes @c descriptor from the epoll set. @c mutex_ must be held.
+    void disarm(int descriptor) {
+        epoll_ctl(epoll_, EPOLL_CTL_DEL, descriptor, nullptr);
+    }
+
+    void wait(int timeout, std::vector<Continuation> &ready) {
+        epoll_event events[64];
+        auto count = epoll_wait(epoll_, events, 64, timeout);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 0; i < count; i++) {
+            auto descriptor = events[i].data.fd;
+            if (descriptor == pipe_[0]) {
+                drainPipe();
+                continue;
+            }
+            auto it = watchers_.find(descriptor);
+            if (it == watchers_.end()) {
+                continue;
+            }
+            auto flags = events[i].events;
+            if (flags & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                fire(it->second.reader, ready);
+            }
+            if (flags & (EPOLLOUT | EPOLLHUP | EPOLLERR)) {
+                fire(it->second.writer, ready);
+            }
+            if (it->second.reader.waiting || it->second.writer.waiting) {
+                arm(descriptor, it->second);
+            }
+            else {
+                watchers_.erase(it);
+            }
+        }
+    }
+
+    int epoll_;
+#else
+    void arm(int, const Watcher &) {
+        wakeUp();
+    }
+
+    /// Makes poll() start over without @c descriptor, which might be closed right after.
+    void disarm(int) {
+        wakeUp();
+    }
+
+    void wait(int timeout, std::vector<Continuation> &ready) {
+        std::vector<pollfd> descriptors;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            descriptors.push_back(pollfd { pipe_[0], POLLIN, 0 });
+            for (auto &pair : watchers_) {
+                short events = 0;
+                if (pair.second.reader.waiting) {
+                    events |= POLLIN;
+                }
+                if (pair.second.writer.waiting) {
+                    events |= POLLOUT;
+                }
+                descriptors.push_back(pollfd { pair.first, events, 0 });
+            }
+        }
+        if (poll(descriptors.data(), descriptors.size(), timeout) <= 0) {
+            return;
+        }
+        if (descriptors[0].revents != 0) {
+            drainPipe();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 1; i < descriptors.size(); i++) {
+            auto flags = descriptors[i].revents;
+            auto it = watchers_.find(descriptors[i].fd);
+            if (flags == 0 || it == watchers_.end()) {
+                continue;
+            }
+            if (flags & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) {
+                fire(it->second.reader, ready);
+            }
+            if (flags & (POLLOUT | POLLHUP | POLLERR | POLLNVAL)) {
+                fire(it->second.writer, ready);
+            }
+            if (!it->second.reader.waiting && !it->second.writer.waiting) {
+                watchers_.erase(it);
+            }
+        }
+    }
+#endif
+
+    int pipe_[2];
+    std::mutex mutex_;
+    std::map<TimerKey, Continuation> timers_;
+    /// The due time of every timer in @c timers_ by its identifier.
+    std::unordered_map<runtime::Integer, Clock::time_point> timerDues_;
+    runtime::Integer nextTimer_ = 0;
+    std::unordered_map<int, Watcher> watchers_;
+};
+
+void watchDescriptor(int descriptor, bool write, runtime::Callable<void> callable) {
+    EventLoop::shared().watch(descriptor, write, EventLoop::Continuation(callable));
+}
+
+void forgetDescriptor(int descriptor) {
+    EventLoop::shared().forget(descriptor);
+}
+
+extern "C" runtime::Integer sEventLoopAfter(runtime::ClassInfo *, runtime::Integer mcs,
+                                            runtime::Callable<void> callable) {
+    return EventLoop::shared().after(mcs, EventLoop::Continuation(callable));
+}
+
+extern "C" runtime::Boolean sEventLoopCancel(runtime::ClassInfo *, runtime::Integer timer) {
+    return EventLoop::shared().cancel(timer);
+}
+
+extern "C" void sEventLoopWhenReadable(runtime::ClassInfo *, runtime::Integer descriptor,
+                                       runtime::Callable<void> callable) {
+    watchDescriptor(static_cast<int>(descriptor), false, callable);
+}
+
+extern "C" void sEventLoopWhenWritable(runtime::ClassInfo *, runtime::Integer descriptor,
+                                       runtime::Callable<void> callable) {
+    watchDescriptor(static_cast<int>(descriptor), true, callable);
+}
+
+extern "C" void sEventLoopSleep(runtime::ClassInfo *, runtime::Integer mcs, int8_t *coroutine) {
+    EventLoop::shared().after(mcs, EventLoop::Continuation(coroutine));
+}
+
+extern "C" void sEventLoopAwaitReadable(runtime::ClassInfo *, runtime::Integer descriptor, int8_t *coroutine) {
+    EventLoop::shared().watch(static_cast<int>(descriptor), false, EventLoop::Continuation(coroutine));
+}
+
+extern "C" void sEventLoopAwaitWritable(runtime::ClassInfo *, runtime::Integer descriptor, int8_t *coroutine) {
+    EventLoop::shared().watch(static_cast<int>(descriptor), true, EventLoop::Continuation(coroutine));
+}
+
+extern "C" void sEventLoopForget(runtime::ClassInfo *, runtime::Integer descriptor) {
+    forgetDescriptor(static_cast<int>(descriptor));
+}
+
+}  // namespace s
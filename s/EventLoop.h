@@ -0,0 +1,26 @@
+#ifndef EMOJICODE_EVENTLOOP_H
+#define EMOJICODE_EVENTLOOP_H
+
+#include "../runtime/Runtime.h"
+
+namespace s {
+
+/// Calls @c callable on one of the worker threads that run 🎬. The callable is retained until it has been called.
+void runTask(runtime::Callable<void> callable);
+
+/// Resumes the suspended coroutine of an ⏯ function on one of the worker threads that run 🎬.
+void resumeTask(int8_t *coroutine);
+
+/// Calls @c callable as a task once @c descriptor can be read from, or written to if @c write is true, without
+/// blocking. The callable is retained until it has been called. Only one callable for reading and one for writing can
+/// be registered for a descriptor at a time; registering another one replaces the previous one.
+void watchDescriptor(int descriptor, bool write, runtime::Callable<void> callable);
+
+/// Releases the callables registered with watchDescriptor() for @c descriptor without calling them and resumes the
+/// ⏯ functions awaiting it. Must be called before @c descriptor is closed, otherwise they are never called nor
+/// released.
+void forgetDescriptor(int descriptor);
+
+}  // namespace s
+
+#endif //EMOJICODE_EVENTLOOP_H
@@ -0,0 +1,89 @@
+#include "LockProfile.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <dlfcn.h>
+
+namespace s {
+
+const bool kProfileLocks = std::getenv("EMOJICODE_PROFILE_LOCKS") != nullptr;
+
+/// All lock sites. The registry is never destructed so that the report printed at exit can still access it.
+struct LockSiteRegistry {
+    std::mutex mutex;
+    std::unordered_map<void *, std::unique_ptr<LockSite>> sites;
+};
+
+static LockSiteRegistry& registry() {
+    static auto registry = new LockSiteRegistry();
+    return *registry;
+}
+
+/// Describes the site as the name of the binary and the offset of the address in it, which can be passed to
+/// `addr2line -f -e`, and the name of the enclosing function if it is exported.
+static std::string describe(const LockSite &site) {
+    char buffer[512];
+    Dl_info info;
+    if (dladdr(site.address, &info) == 0 || info.dli_fname == nullptr) {
+        std::snprintf(buffer, sizeof(buffer), "%p", site.address);
+        return buffer;
+    }
+    auto offset = static_cast<const char *>(site.address) - static_cast<const char *>(info.dli_fbase);
+    if (info.dli_sname != nullptr) {
+        std::snprintf(buffer, sizeof(buffer), "%s+0x%tx (%s)", info.dli_fname, offset, info.dli_sname);
+    }
+    else {
+        std::snprintf(buffer, sizeof(buffer), "%s+0x%tx", info.dli_fname, offset);
+    }
+    return buffer;
+}
+
+static void printReport() {
+    auto &registry = s::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<LockSite *> sites;
+    for (auto &pair : registry.sites) {
+        sites.emplace_back(pair.second.get());
+    }
+    std::sort(sites.begin(), sites.end(), [](LockSite *a, LockSite *b) {
+        return a->waitNanoseconds.load() > b->waitNanoseconds.load();
+    });
+
+    std::fprintf(stderr, "🔐 lock profile, sorted by total wait time\n");
+    std::fprintf(stderr, "%12s %12s %12s %12s %12s %12s  %s\n", "acquired", "contended", "wait ms", "max wait µs",
+                 "hold ms", "max hold µs", "site");
+    for (auto site : sites) {
+        auto name = site->name.empty() ? describe(*site) : site->name + " at " + describe(*site);
+        std::fprintf(stderr, "%12" PRIu64 " %12" PRIu64 " %12.3f %12.1f %12.3f %12.1f  %s\n",
+                     site->acquisitions.load(), site->contended.load(), site->waitNanoseconds.load() / 1e6,
+                     site->maxWaitNanoseconds.load() / 1e3, site->holdNanoseconds.load() / 1e6,
+                     site->maxHoldNanoseconds.load() / 1e3, name.c_str());
+    }
+}
+
+LockSite* lockSite(void *address) {
+    auto &registry = s::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (registry.sites.empty()) {
+        std::atexit(printReport);
+    }
+    auto &site = registry.sites[address];
+    if (site == nullptr) {
+        site = std::make_unique<LockSite>(address);
+    }
+    return site.get();
+}
+
+void nameLockSite(LockSite *site, const std::string &name) {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    if (site->name.empty()) {
+        site->name = name;
+    }
+}
+
+}  // namespace s
@@ -0,0 +1,45 @@
+#ifndef EMOJICODE_LOCKPROFILE_H
+#define EMOJICODE_LOCKPROFILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace s {
+
+/// Statistics of all mutexes that were created by the same call in the program.
+struct LockSite {
+    explicit LockSite(void *address) : address(address) {}
+
+    /// The return address of the call that created the mutexes.
+    void *const address;
+    /// The name given to one of the mutexes with 📛, if any.
+    std::string name;
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> waitNanoseconds{0};
+    std::atomic<uint64_t> maxWaitNanoseconds{0};
+    std::atomic<uint64_t> holdNanoseconds{0};
+    std::atomic<uint64_t> maxHoldNanoseconds{0};
+};
+
+/// True if the environment variable `EMOJICODE_PROFILE_LOCKS` was set when the program started. Mutexes only collect
+/// statistics in this case.
+extern const bool kProfileLocks;
+
+/// Returns the statistics for mutexes created by the call that returns to @c address. A report of all sites is
+/// printed to stderr when the program exits.
+LockSite* lockSite(void *address);
+
+/// Sets the name of @c site to @c name unless it already has one.
+void nameLockSite(LockSite *site, const std::string &name);
+
+/// Atomically sets @c maximum to @c value if @c value is larger.
+inline void recordMaximum(std::atomic<uint64_t> &maximum, uint64_t value) {
+    auto current = maximum.load(std::memory_order_relaxed);
+    while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+}  // namespace s
+
+#endif //EMOJICODE_LOCKPROFILE_H
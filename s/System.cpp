@@ -5,6 +5,7 @@
 #include "../runtime/Runtime.h"
 #include "../runtime/Internal.hpp"
 #include "String.h"
+#include <chrono>
 #include <cstdlib>
 #include <ctime>
 
@@ -16,6 +17,11 @@ extern "C" runtime::Integer sSystemUnixTimestamp(runtime::ClassInfo*) {
     return std::time(0);
 }
 
+extern "C" runtime::Integer sSystemMonotonicTime(runtime::ClassInfo*) {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
 extern "C" runtime::SimpleOptional<s::String*> sSystemGetEnv(runtime::ClassInfo*, s::String *name) {
     auto var = std::getenv(name->stdString().c_str());
     if (var != nullptr) {
@@ -0,0 +1,261 @@
+#include "../runtime/Runtime.h"
+#include "EventLoop.h"
+#include "Task.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace s {
+
+class Task : public runtime::Object<Task> {
+public:
+    explicit Task(runtime::Callable<void> callable) : callable(callable) {}
+    /// Creates a task that runs native code, see TaskGroup.
+    explicit Task(std::function<void()> function) : function(std::move(function)) {}
+
+    /// Only valid if @c function is empty.
+    runtime::Callable<void> callable;
+    std::function<void()> function;
+    std::atomic_bool done { false };
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        finished.notify_all();
+    }
+};
+
+/// Runs tasks on a fixed number of worker threads. Every worker has its own deque: A worker pushes the tasks it
+/// creates to the back of its deque and takes tasks from the back, so that it works on the tasks that are most likely
+/// still in its cache. A worker whose deque is empty steals from the front of the deques of other workers.
+class Scheduler {
+public:
+    static Scheduler& shared() {
+        static auto scheduler = new Scheduler(workerCountFromEnvironment());
+        return *scheduler;
+    }
+
+    size_t workerCount() const { return workers_.size(); }
+
+    void submit(Task *task) {
+        task->retain();
+        if (!task->function) {
+            task->callable.retain();
+        }
+        auto index = current_ != nullptr ? current_->index : next_++ % workers_.size();
+        {
+            std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+            workers_[index]->deque.push_back(task);
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            pending_++;
+        }
+        wakeUp_.notify_one();
+    }
+
+    void wait(Task *task) {
+        if (current_ == nullptr) {
+            std::unique_lock<std::mutex> lock(task->mutex);
+            task->finished.wait(lock, [task] { return task->done.load(); });
+            return;
+        }
+        // A worker must not block while waiting as the task it waits for might be in its own deque.
+        while (!task->done.load()) {
+            if (auto other = take(*current_)) {
+                run(other);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(task->mutex);
+            task->finished.wait_for(lock, std::chrono::microseconds(100), [task] { return task->done.load(); });
+        }
+    }
+
+private:
+    struct Worker {
+        explicit Worker(size_t index) : index(index) {}
+        size_t index;
+        std::mutex mutex;
+        std::deque<Task *> deque;
+    };
+
+    explicit Scheduler(size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            workers_.emplace_back(std::make_unique<Worker>(i));
+        }
+        for (auto &worker : workers_) {
+            std::thread([this, worker = worker.get()]() { work(worker); }).detach();
+        }
+    }
+
+    static size_t workerCountFromEnvironment() {
+        if (auto var = std::getenv("EMOJICODE_WORKERS")) {
+            auto count = std::atoi(var);
+            if (count > 0) {
+                return static_cast<size_t>(count);
+            }
+        }
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /// Names the worker thread so that it can be told apart in `top` or a debugger and, if the environment variable
+    /// `EMOJICODE_PIN_WORKERS` is set, restricts it to one of the processors the program may run on.
+    static void setUpWorkerThread(Worker *worker) {
+#ifdef __linux__
+        auto name = "emojicode-w" + std::to_string(worker->index);
+        pthread_setname_np(pthread_self(), name.c_str());
+        cpu_set_t allowed;
+        if (std::getenv("EMOJICODE_PIN_WORKERS") == nullptr || sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            return;
+        }
+        auto n = worker->index % CPU_COUNT(&allowed);
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed) && n-- == 0) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+                return;
+            }
+        }
+#endif
+    }
+
+    void work(Worker *worker) {
+        current_ = worker;
+        setUpWorkerThread(worker);
+        while (true) {
+            if (auto task = take(*worker)) {
+                run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wakeUp_.wait(lock, [this] { return pending_ > 0; });
+        }
+    }
+
+    Task* take(Worker &worker) {
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (!worker.deque.empty()) {
+                auto task = worker.deque.back();
+                worker.deque.pop_back();
+                pending_--;
+                return task;
+            }
+        }
+        for (size_t i = 1; i < workers_.size(); i++) {
+            auto &victim = *workers_[(worker.index + i) % workers_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.deque.empty()) {
+                auto task = victim.deque.front();
+                victim.deque.pop_front();
+                pending_--;
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void run(Task *task) {
+        if (task->function) {
+            task->function();
+        }
+        else {
+            task->callable();
+            task->callable.release();
+        }
+        task->finish();
+        task->release();
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic_size_t next_ { 0 };
+    std::atomic_int pending_ { 0 };
+    std::mutex sleepMutex_;
+    std::condition_variable wakeUp_;
+    static thread_local Worker *current_;
+};
+
+thread_local Scheduler::Worker *Scheduler::current_ = nullptr;
+
+void runTask(runtime::Callable<void> callable) {
+    auto task = Task::init(callable);
+    Scheduler::shared().submit(task);
+    task->release();
+}
+
+void resumeTask(int8_t *coroutine) {
+    auto task = Task::init([coroutine] { ejcCoroutineResume(coroutine); });
+    Scheduler::shared().submit(task);
+    task->release();
+}
+
+TaskGroup::TaskGroup() : finished_(Task::init(std::function<void()>())) {}
+
+TaskGroup::~TaskGroup() {
+    finished_->release();
+}
+
+void TaskGroup::run(std::function<void()> function) {
+    count_++;
+    // The group might be destructed as soon as the last task finished it.
+    auto finished = finished_;
+    finished->retain();
+    auto task = Task::init([this, function, finished] {
+        function();
+        if (--count_ == 0) {
+            finished->finish();
+        }
+        finished->release();
+    });
+    Scheduler::shared().submit(task);
+    task->release();
+}
+
+void TaskGroup::wait() {
+    if (count_ > 0) {
+        Scheduler::shared().wait(finished_);
+    }
+}
+
+extern "C" Task* sTaskNew(runtime::Callable<void> callable) {
+    auto task = Task::init(callable);
+    Scheduler::shared().submit(task);
+    return task;
+}
+
+extern "C" void sTaskWait(Task *task) {
+    Scheduler::shared().wait(task);
+}
+
+extern "C" runtime::Boolean sTaskIsDone(Task *task) {
+    return task->done.load();
+}
+
+extern "C" runtime::Integer sTaskWorkerCount(runtime::ClassInfo *) {
+    return Scheduler::shared().workerCount();
+}
+
+extern "C" void sTaskDestruct(Task *task) {
+    task->~Task();
+}
+
+}  // namespace s
+
+SET_INFO_FOR(s::Task, s, 1f3ac)
@@ -0,0 +1,34 @@
+#ifndef EMOJICODE_TASK_H
+#define EMOJICODE_TASK_H
+
+#include "../runtime/Runtime.h"
+#include <atomic>
+#include <functional>
+
+namespace s {
+
+class Task;
+
+/// Lets native code run work on the worker threads that run 🎬 and wait for it. Tasks of the group can run further
+/// tasks in the group. A group can only be waited for once, and no tasks must be run in it after wait() returned.
+class TaskGroup {
+public:
+    TaskGroup();
+    ~TaskGroup();
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// Calls @c function as a task.
+    void run(std::function<void()> function);
+    /// Blocks until all tasks of the group have finished. A worker thread runs other tasks in the meantime.
+    void wait();
+
+private:
+    std::atomic<size_t> count_ { 0 };
+    /// Marked as done once @c count_ drops to zero. It is never submitted.
+    Task *finished_;
+};
+
+}  // namespace s
+
+#endif //EMOJICODE_TASK_H
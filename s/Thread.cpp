@@ -3,8 +3,26 @@
 //
 
 #include "../runtime/Runtime.h"
+#include "LockProfile.h"
+#include "String.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <vector>
+#ifdef __linux__
+#include <cerrno>
+#include <climits>
+#include <fstream>
+#include <linux/futex.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace s {
 
@@ -16,6 +34,15 @@ public:
 class Mutex : public runtime::Object<Mutex> {
 public:
     std::mutex mutex;
+    /// The statistics this mutex contributes to, or nullptr if locks are not profiled.
+    LockSite *site = nullptr;
+    /// When the mutex was locked the last time. Only valid if site is not nullptr.
+    std::chrono::steady_clock::time_point lockedAt;
+};
+
+class ThreadLocal : public runtime::Object<ThreadLocal> {
+public:
+    size_t index;
 };
 
 extern "C" Thread* sThreadNew(runtime::Callable<void> callable) {
@@ -42,27 +69,374 @@ extern "C" void sThreadDelay(runtime::ClassInfo *, runtime::Integer mcs) {
     std::this_thread::sleep_for(std::chrono::microseconds(mcs));
 }
 
+#ifdef __linux__
+
+/// Reads the CPUs of a NUMA node from sysfs, where they are listed as comma-separated ranges like `0-3,8-11`.
+static bool nodeCPUs(runtime::Integer node, cpu_set_t *set) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!std::getline(file, list)) {
+        return false;
+    }
+    CPU_ZERO(set);
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        auto dash = range.find('-');
+        auto first = std::stoi(range.substr(0, dash));
+        auto last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (auto cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, set);
+        }
+    }
+    return CPU_COUNT(set) > 0;
+}
+
+#endif
+
+extern "C" runtime::Boolean sThreadSetAffinity(Thread *thread, runtime::Integer cpu) {
+#ifdef __linux__
+    if (!thread->thread.joinable() || cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread->thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+extern "C" runtime::Boolean sThreadSetName(Thread *thread, String *name) {
+#ifdef __linux__
+    if (!thread->thread.joinable()) {
+        return false;
+    }
+    // Linux limits names to 15 bytes. Cut the name before the first character that does not fit completely.
+    auto string = name->stdString();
+    if (string.size() > 15) {
+        auto end = 15;
+        while (end > 0 && (string[end] & 0xC0) == 0x80) {
+            end--;
+        }
+        string.resize(end);
+    }
+    return pthread_setname_np(thread->thread.native_handle(), string.c_str()) == 0;
+#else
+    return false;
+#endif
+}
+
+extern "C" runtime::Integer sThreadCurrentProcessor(runtime::ClassInfo *) {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+extern "C" runtime::Boolean sThreadMoveToNode(runtime::ClassInfo *, runtime::Integer node) {
+#ifdef __linux__
+    cpu_set_t set;
+    if (node < 0 || node >= static_cast<runtime::Integer>(sizeof(unsigned long) * CHAR_BIT) || !nodeCPUs(node, &set)) {
+        return false;
+    }
+    unsigned long nodes = 1ul << node;
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 &&
+        syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodes, sizeof(nodes) * CHAR_BIT) == 0;
+#else
+    return false;
+#endif
+}
+
 extern "C" Mutex* sMutexNew() {
-    return Mutex::init();
+    auto mutex = Mutex::init();
+    if (kProfileLocks) {
+        mutex->site = lockSite(__builtin_return_address(0));
+    }
+    return mutex;
+}
+
+static uint64_t nanosecondsSince(std::chrono::steady_clock::time_point start) {
+    auto duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+static void profiledLock(Mutex *mutex) {
+    auto site = mutex->site;
+    if (!mutex->mutex.try_lock()) {
+        auto start = std::chrono::steady_clock::now();
+        mutex->mutex.lock();
+        auto wait = nanosecondsSince(start);
+        site->contended.fetch_add(1, std::memory_order_relaxed);
+        site->waitNanoseconds.fetch_add(wait, std::memory_order_relaxed);
+        recordMaximum(site->maxWaitNanoseconds, wait);
+    }
+    site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    mutex->lockedAt = std::chrono::steady_clock::now();
 }
 
 extern "C" void sMutexLock(Mutex *mutex) {
-    mutex->mutex.lock();
+    if (mutex->site == nullptr) {
+        mutex->mutex.lock();
+        return;
+    }
+    profiledLock(mutex);
 }
 
-extern "C" void sMutexTryLock(Mutex *mutex) {
-    mutex->mutex.try_lock();
+extern "C" runtime::Boolean sMutexTryLock(Mutex *mutex) {
+    if (!mutex->mutex.try_lock()) {
+        return false;
+    }
+    if (mutex->site != nullptr) {
+        mutex->site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        mutex->lockedAt = std::chrono::steady_clock::now();
+    }
+    return true;
 }
 
 extern "C" void sMutexUnlock(Mutex *mutex) {
+    if (mutex->site != nullptr) {
+        auto hold = nanosecondsSince(mutex->lockedAt);
+        mutex->site->holdNanoseconds.fetch_add(hold, std::memory_order_relaxed);
+        recordMaximum(mutex->site->maxHoldNanoseconds, hold);
+    }
     mutex->mutex.unlock();
 }
 
+extern "C" void sMutexSetName(Mutex *mutex, String *name) {
+    if (mutex->site != nullptr) {
+        nameLockSite(mutex->site, name->stdString());
+    }
+}
+
 extern "C" void sMutexDestruct(Mutex *mutex) {
     mutex->~Mutex();
 }
 
+/// The values of the thread-local variables of one thread. Every value is a 🧠 that holds an object reference, which
+/// is released together with the 🧠 when the thread exits or when the 🗳 it belongs to is destructed.
+///
+/// Only the owning thread allocates values, but any thread can take them out when it destructs a 🗳. @c mutex_ guards
+/// resizing @c slots_ against this, so the owning thread only needs to lock when it grows the storage.
+class ThreadLocalStorage {
+public:
+    ThreadLocalStorage() {
+        auto &registry = Registry::shared();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.storages.push_back(this);
+    }
+
+    ~ThreadLocalStorage() {
+        {
+            auto &registry = Registry::shared();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.storages.erase(std::find(registry.storages.begin(), registry.storages.end(), this));
+        }
+        for (auto memory : slots_) {
+            release(memory);
+        }
+    }
+
+    int8_t* memory(ThreadLocal *local) {
+        if (slots_.size() <= local->index) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots_.resize(local->index + 1, nullptr);
+        }
+        auto &memory = slots_[local->index];
+        if (memory == nullptr) {
+            memory = ejcAlloc(sizeof(runtime::internal::ControlBlock *) + sizeof(runtime::Object<void> *));
+            *object(memory) = nullptr;
+        }
+        ejcRetain(reinterpret_cast<runtime::Object<void> *>(memory));
+        return memory;
+    }
+
+    /// Takes the value at @c index out of the storage of every thread and appends it to @c memories. No thread may
+    /// access @c index concurrently, i.e. its 🗳 must be being destructed.
+    static void takeAll(size_t index, std::vector<int8_t *> *memories) {
+        auto &registry = Registry::shared();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto storage : registry.storages) {
+            std::lock_guard<std::mutex> storageLock(storage->mutex_);
+            if (index < storage->slots_.size() && storage->slots_[index] != nullptr) {
+                memories->push_back(storage->slots_[index]);
+                storage->slots_[index] = nullptr;
+            }
+        }
+    }
+
+    /// Releases a value and the 🧠 that holds it.
+    static void release(int8_t *memory) {
+        if (memory == nullptr) {
+            return;
+        }
+        if (auto value = *object(memory)) {
+            *object(memory) = nullptr;
+            ejcRelease(value);
+        }
+        ejcReleaseMemory(reinterpret_cast<runtime::Object<void> *>(memory));
+    }
+
+private:
+    /// The storages of all running threads.
+    struct Registry {
+        static Registry& shared() {
+            static auto registry = new Registry();
+            return *registry;
+        }
+
+        std::mutex mutex;
+        std::vector<ThreadLocalStorage *> storages;
+    };
+
+    static runtime::Object<void>** object(int8_t *memory) {
+        return reinterpret_cast<runtime::Object<void> **>(memory + sizeof(runtime::internal::ControlBlock *));
+    }
+
+    std::mutex mutex_;
+    std::vector<int8_t *> slots_;
+};
+
+/// Hands out the indices of thread-local variables. An index is reused once its 🗳 has been destructed and the values
+/// all threads held for it have been released.
+class ThreadLocalIndices {
+public:
+    static ThreadLocalIndices& shared() {
+        static auto indices = new ThreadLocalIndices();
+        return *indices;
+    }
+
+    void take(ThreadLocal *local) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty()) {
+            local->index = count_++;
+        }
+        else {
+            local->index = free_.back();
+            free_.pop_back();
+        }
+    }
+
+    void giveBack(ThreadLocal *local) {
+        std::vector<int8_t *> memories;
+        ThreadLocalStorage::takeAll(local->index, &memories);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(local->index);
+        }
+        // Releasing might run deinitializers that destruct other 🗳, so no lock must be held.
+        for (auto memory : memories) {
+            ThreadLocalStorage::release(memory);
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    size_t count_ = 0;
+    std::vector<size_t> free_;
+};
+
+static thread_local ThreadLocalStorage threadLocalStorage;
+
+extern "C" ThreadLocal* sThreadLocalNew() {
+    auto local = ThreadLocal::init();
+    ThreadLocalIndices::shared().take(local);
+    return local;
+}
+
+extern "C" int8_t* sThreadLocalMemory(ThreadLocal *local) {
+    return threadLocalStorage.memory(local);
+}
+
+extern "C" void sThreadLocalDestruct(ThreadLocal *local) {
+    ThreadLocalIndices::shared().giveBack(local);
+    local->~ThreadLocal();
+}
+
+static runtime::Integer* memoryAddress(int8_t **memory, runtime::Integer offset) {
+    return reinterpret_cast<runtime::Integer *>(*memory + sizeof(runtime::internal::ControlBlock *) + offset);
+}
+
+#ifdef __linux__
+
+/// A futex is 32 bits wide, so the waiting threads are parked on the low half of the 🔢 and only the low half is
+/// compared with the expected value. A change confined to the high 32 bits, or one that wraps the low half around to
+/// the expected value, is therefore not detected: the waiter goes to sleep anyway. Such a change must be paired with
+/// an explicit wake.
+static int* futexAddress(int8_t **memory, runtime::Integer offset) {
+    auto address = reinterpret_cast<int *>(memoryAddress(memory, offset));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return address + 1;
+#else
+    return address;
+#endif
+}
+
+extern "C" void sMemoryWait(int8_t **memory, runtime::Integer offset, runtime::Integer expected) {
+    syscall(SYS_futex, futexAddress(memory, offset), FUTEX_WAIT_PRIVATE, static_cast<int>(expected), nullptr,
+            nullptr, 0);
+}
+
+extern "C" runtime::Boolean sMemoryWaitTimeout(int8_t **memory, runtime::Integer offset, runtime::Integer expected,
+                                               runtime::Integer mcs) {
+    timespec timeout{};
+    timeout.tv_sec = mcs / 1000000;
+    timeout.tv_nsec = (mcs % 1000000) * 1000;
+    auto result = syscall(SYS_futex, futexAddress(memory, offset), FUTEX_WAIT_PRIVATE, static_cast<int>(expected),
+                          &timeout, nullptr, 0);
+    return result == 0 || errno != ETIMEDOUT;
+}
+
+extern "C" void sMemoryWake(int8_t **memory, runtime::Integer offset, runtime::Integer count) {
+    syscall(SYS_futex, futexAddress(memory, offset), FUTEX_WAKE_PRIVATE,
+            count < INT_MAX ? static_cast<int>(count) : INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+/// Without futexes, threads wait on one of a fixed number of condition variables chosen by the address.
+struct ParkingSpot {
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+static ParkingSpot& parkingSpot(runtime::Integer *address) {
+    static ParkingSpot spots[64];
+    return spots[(reinterpret_cast<uintptr_t>(address) >> 3) % 64];
+}
+
+extern "C" void sMemoryWait(int8_t **memory, runtime::Integer offset, runtime::Integer expected) {
+    auto address = memoryAddress(memory, offset);
+    auto &spot = parkingSpot(address);
+    std::unique_lock<std::mutex> lock(spot.mutex);
+    if (__atomic_load_n(address, __ATOMIC_SEQ_CST) == expected) {
+        spot.condition.wait(lock);
+    }
+}
+
+extern "C" runtime::Boolean sMemoryWaitTimeout(int8_t **memory, runtime::Integer offset, runtime::Integer expected,
+                                               runtime::Integer mcs) {
+    auto address = memoryAddress(memory, offset);
+    auto &spot = parkingSpot(address);
+    std::unique_lock<std::mutex> lock(spot.mutex);
+    if (__atomic_load_n(address, __ATOMIC_SEQ_CST) == expected) {
+        return spot.condition.wait_for(lock, std::chrono::microseconds(mcs)) == std::cv_status::no_timeout;
+    }
+    return 1;
+}
+
+extern "C" void sMemoryWake(int8_t **memory, runtime::Integer offset, runtime::Integer count) {
+    auto &spot = parkingSpot(memoryAddress(memory, offset));
+    { std::lock_guard<std::mutex> lock(spot.mutex); }
+    spot.condition.notify_all();
+}
+
+#endif
+
 }  // namespace s
 
 SET_INFO_FOR(s::Thread, s, 1f488)
 SET_INFO_FOR(s::Mutex, s, 1f510)
+SET_INFO_FOR(s::ThreadLocal, s, 1f5f3)
@@ -4,6 +4,7 @@
 
 #include "../runtime/Runtime.h"
 #include "../s/Data.h"
+#include "../s/EventLoop.h"
 #include "../s/String.h"
 #include <arpa/inet.h>
 #include <cerrno>
@@ -83,7 +84,13 @@ extern "C" runtime::SimpleError<Socket*> socketsSocketNewHost(String *host, runt
 }
 
 extern "C" void socketsSocketClose(Socket *socket) {
+    // The deinitializer closes again, when the descriptor might already belong to another file.
+    if (socket->socket_ == -1) {
+        return;
+    }
+    s::forgetDescriptor(socket->socket_);
     close(socket->socket_);
+    socket->socket_ = -1;
 }
 
 extern "C" runtime::SimpleOptional<runtime::Enum> socketsSocketSend(Socket *socket, Data *data) {
@@ -104,8 +111,17 @@ extern "C" runtime::SimpleError<Data*> socketsSocketRead(Socket *socket, runtime
     return data;
 }
 
+extern "C" void socketsSocketWhenReadable(Socket *socket, runtime::Callable<void> callback) {
+    s::watchDescriptor(socket->socket_, false, callback);
+}
+
 extern "C" void socketsServerClose(Server *server) {
+    if (server->socket_ == -1) {
+        return;
+    }
+    s::forgetDescriptor(server->socket_);
     close(server->socket_);
+    server->socket_ = -1;
 }
 
 extern "C" runtime::SimpleError<Server*> socketsServerNewPort(runtime::Integer port) {
@@ -147,6 +163,10 @@ extern "C" runtime::SimpleError<Socket *> socketsServerAccept(Server *server) {
     return socket;
 }
 
+extern "C" void socketsServerWhenReadable(Server *server, runtime::Callable<void> callback) {
+    s::watchDescriptor(server->socket_, false, callback);
+}
+
 }  // namespace sockets
 
 SET_INFO_FOR(sockets::Socket, sockets, 1f4de)
@@ -85,6 +85,7 @@ compilation_tests = [
     "rcOrderVt",
     "rcTempOrder",
     "rcInstanceVariable",
+    "async",
 ]
 
 if not quick:
@@ -92,7 +93,10 @@ if not quick:
       "stressTest1",
       "stressTest2",
       "stressTest3",
-      "stressTest4"
+      "stressTest4",
+      "stressTest5",
+      "stressTest6",
+      "stressTest7"
     ])
 
 library_tests = [
@@ -105,6 +109,22 @@ library_tests = [
     "listTest",
     "enumerator",
     "dictionaryTest",
+    "setTest",
+    "orderedMapTest",
+    "dequeTest",
+    "priorityQueueTest",
+    "bitSetTest",
+    "numericArrayTest",
+    "persistentTest",
+    "concurrentMapTest",
+    "taskTest",
+    "parallelTest",
+    "atomicTest",
+    "channelTest",
+    "syncTest",
+    "eventLoopTest",
+    "threadLocalTest",
+    "threadTest",
     # "jsonTest",
     "fileTest"
 ]
@@ -197,6 +217,10 @@ os.chdir(os.path.join(dist.source, "tests", "s"))
 os.environ["TEST_ENV_1"] = "The day starts like the rest I've seen"
 for test in library_tests:
     library_test(test)
+# Run the file test again to cover the thread pool that 🚛 uses without io_uring.
+os.environ["EMOJICODE_NO_IO_URING"] = "1"
+library_test("fileTest")
+del os.environ["EMOJICODE_NO_IO_URING"]
 
 for file in avl_compilation_tests:
     print("☢️  {0} is not in compilation test list.".format(file))